@@ -0,0 +1,132 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+/**
+ * @file Benchmark of concurrent updates of a shared compensated sum.
+ *
+ * Each of several threads adds its share of the values to a single shared
+ * total, using one of the following strategies:
+ *
+ * • mutex:        a value<double> protected by a std::mutex,
+ * • atomic:       an atomic_value<double>, with one fetch_add() per value,
+ * • sharded:      a sharded_value<double>, with one addition per value,
+ * • thread-local: a value<double> per thread, added to an atomic_value<double>
+ *                 with a single fetch_add() at the end.
+ *
+ * The program prints the throughput of each strategy, in millions of
+ * additions per second, for 1 to 128 threads. The first two strategies show
+ * the cost of contention on a single cache line, which the sharded sum
+ * avoids.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "compensated.h"
+
+using compensated::value;
+using compensated::atomic_value;
+using compensated::sharded_value;
+
+/**
+ * @brief Runs `work(t)` on `threads` threads, for t = 0, ..., threads - 1,
+ * and returns the elapsed time in seconds
+ */
+template<typename Work>
+static double run_threads(unsigned threads, Work work)
+{
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back(work, t);
+    for (auto& worker : workers)
+        worker.join();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+/**
+ * @brief The i-th value added by thread t: large and small values alternate
+ */
+static inline double summand(unsigned t, unsigned long i)
+{
+    return (i % 2) ? 1e-8 * (t + 1) : 1e8;
+}
+
+int main(int argc, char* argv[])
+{
+    const unsigned long additions = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    std::printf("Concurrent compensated additions of doubles (%lu in total)\n", additions);
+    std::printf("atomic_value<double> is %slock-free\n",
+                atomic_value<double>{}.is_lock_free() ? "" : "NOT ");
+    std::printf("%8s %14s %14s %14s %14s   (millions of additions per second)\n",
+                "threads", "mutex", "atomic", "sharded", "thread-local");
+
+    for (unsigned threads = 1; threads <= 128; threads *= 2)
+    {
+        const unsigned long share = additions / threads;
+        const double total = double(share) * threads;
+
+        std::mutex lock;
+        value<double> locked_sum;
+        const double mutex_time = run_threads(threads, [&](unsigned t)
+        {
+            for (unsigned long i = 0; i < share; i++)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                locked_sum += summand(t, i);
+            }
+        });
+
+        atomic_value<double> atomic_sum;
+        const double atomic_time = run_threads(threads, [&](unsigned t)
+        {
+            for (unsigned long i = 0; i < share; i++)
+                atomic_sum += summand(t, i);
+        });
+
+        sharded_value<double> sharded_sum;
+        const double sharded_time = run_threads(threads, [&](unsigned t)
+        {
+            for (unsigned long i = 0; i < share; i++)
+                sharded_sum += summand(t, i);
+        });
+
+        atomic_value<double> merged_sum;
+        const double local_time = run_threads(threads, [&](unsigned t)
+        {
+            value<double> local_sum;
+            for (unsigned long i = 0; i < share; i++)
+                local_sum += summand(t, i);
+            merged_sum += local_sum;
+        });
+
+        // All strategies compute the same sum:
+        if (double(locked_sum) != double(atomic_sum.load())
+            || double(locked_sum) != double(sharded_sum.load())
+            || double(locked_sum) != double(merged_sum.load()))
+        {
+            std::printf("Mismatch: %.17g %.17g %.17g %.17g\n", double(locked_sum),
+                        double(atomic_sum.load()), double(sharded_sum.load()),
+                        double(merged_sum.load()));
+            return EXIT_FAILURE;
+        }
+
+        std::printf("%8u %14.2f %14.2f %14.2f %14.2f\n", threads,
+                    total / mutex_time / 1e6, total / atomic_time / 1e6,
+                    total / sharded_time / 1e6, total / local_time / 1e6);
+    }
+    return EXIT_SUCCESS;
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
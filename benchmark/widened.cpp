@@ -0,0 +1,124 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+/**
+ * @file Benchmark of the summation of floats: compensated in float, or
+ * widened to double.
+ *
+ * The program sums two data sets of floats with each of the strategies:
+ *
+ * • plain float:       an ordinary loop, for reference,
+ * • compensated float: value<float>,
+ * • widened:           widened_value<float>, a plain sum in double,
+ * • widened Neumaier:  widened_value<float, algorithm::neumaier>,
+ *
+ * and prints the throughput of each, with the relative error of its result
+ * (before the final rounding to float) with respect to the exact sum.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "compensated.h"
+
+using namespace compensated;
+
+/**
+ * @brief Runs `sum()` several times and returns the best time per element
+ * in nanoseconds, with the result of the last run
+ */
+template<typename Sum>
+static double best_time(Sum sum, std::size_t count, double& result)
+{
+    double best = 1e300;
+    for (int repetition = 0; repetition < 5; repetition++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        result = sum();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    return best / double(count);
+}
+
+static void run(const char* title, const std::vector<float>& data)
+{
+    superaccumulator exact;
+    for (float x : data)
+        exact += double(x);
+    const double reference = double(exact);
+
+    std::printf("\n%s: %zu floats, exact sum %.9g\n", title, data.size(), reference);
+    std::printf("%20s %12s %16s\n", "strategy", "ns/element", "relative error");
+    auto report = [&](const char* name, auto sum)
+    {
+        double result;
+        const double time = best_time(sum, data.size(), result);
+        std::printf("%20s %12.3f %16.3g\n", name, time, std::abs(result - reference) / std::abs(reference));
+    };
+
+    report("plain float", [&]()
+    {
+        float sum = 0;
+        for (float x : data)
+            sum += x;
+        return double(sum);
+    });
+    report("compensated float", [&]()
+    {
+        value<float> sum;
+        sum.accumulate(data);
+        return double(float(sum));
+    });
+    report("widened", [&]()
+    {
+        widened_value<float> sum;
+        sum.accumulate(data);
+        return double(sum.wide());
+    });
+    report("widened Neumaier", [&]()
+    {
+        widened_value<float, algorithm::neumaier> sum;
+        sum.accumulate(data);
+        return double(sum.wide());
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (1u << 24);
+    std::mt19937 generator(2021);
+
+    // Readings of a sensor: a large offset with a little noise
+    std::normal_distribution<float> reading(20.0f, 0.5f);
+    std::vector<float> sensor(count);
+    for (auto& x : sensor)
+        x = reading(generator);
+    run("Sensor readings", sensor);
+
+    // Values of both signs spanning many orders of magnitude, nearly cancelling
+    std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(-20, 20);
+    std::vector<float> cancelling(count);
+    for (std::size_t i = 0; i < count; i += 2)
+    {
+        cancelling[i] = std::ldexp(mantissa(generator), exponent(generator));
+        if (i + 1 < count)
+            cancelling[i + 1] = -cancelling[i] * (1.0f + 0x1p-20f);
+    }
+    run("Cancelling values", cancelling);
+    return EXIT_SUCCESS;
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
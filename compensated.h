@@ -31,10 +31,125 @@
 #error Error: compensated.h does not work with fast math/unsafe optimizations.
 #endif
 
-// We include only C++20 standard library headers:
+/* We always include only C++20 standard library headers. Below them, a few
+ * optional or platform headers are included under macros:
+ *  - <execution> with COMPENSATED_PARALLEL (which may require linking TBB),
+ *  - <mdspan> and <stdfloat> when the standard library provides them,
+ *  - <immintrin.h> for the F16C conversions, when __F16C__ is defined (GCC, Clang),
+ *  - <intrin.h> for the 16-byte compare-and-swap on MSVC for x86-64,
+ *  - <cpuid.h> for the check of that instruction with GCC or Clang on x86-64.
+ * The runtime dispatch (COMPENSATED_DISPATCH) needs no header of its own.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <compare>
 #include <concepts>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <ostream>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * The overloads of accumulate() and of the scans taking a standard execution
+ * policy are provided when COMPENSATED_PARALLEL is defined before including
+ * this header, in every translation unit, so that all of them see the same
+ * class definitions. They are opt-in, since some standard libraries
+ * implement the parallel algorithms with a backend library (such as Intel
+ * TBB) which then has to be linked, and since parallel algorithms are
+ * optional in C++20.
+ */
+#if defined(COMPENSATED_PARALLEL) && __has_include(<execution>)
+#include <execution>
+#endif
+#if defined(COMPENSATED_PARALLEL) && defined(__cpp_lib_execution)
+#define COMPENSATED_EXECUTION_POLICIES
+#endif
+
+// The overload of reduce() taking a std::mdspan is provided when it is available (C++23):
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+// The C++23 extended floating-point types std::float16_t and std::bfloat16_t:
+#if __has_include(<stdfloat>)
+#include <stdfloat>
+#endif
+
+// The F16C instructions converting half-precision values to floats:
+#if defined(__F16C__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+// The 16-byte compare-and-swap used by atomic_value<double> is an intrinsic on MSVC:
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Elsewhere on x86-64, the processor is asked whether it has that instruction:
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+/*
+ * Width (in bytes) of the vector registers used by the bulk summation
+ * kernels. By default, it is deduced from the instruction set enabled
+ * for the current translation unit; it can be overridden by defining
+ * COMPENSATED_VECTOR_BYTES before including this header.
+ */
+#ifndef COMPENSATED_VECTOR_BYTES
+    #if defined(__AVX512F__)
+    #define COMPENSATED_VECTOR_BYTES 64
+    #elif defined(__AVX__)
+    #define COMPENSATED_VECTOR_BYTES 32
+    #else
+    #define COMPENSATED_VECTOR_BYTES 16
+    #endif
+#endif
+
+/*
+ * Runtime dispatch of the vectorized summation and dot product kernels is
+ * enabled by defining COMPENSATED_DISPATCH before including this header, in
+ * every translation unit. On x86-64 with GCC or Clang, the kernels are then
+ * also compiled for AVX2 with FMA and for AVX-512, and the best variant
+ * supported by the processor is selected once, when first used, so that a
+ * binary built for the baseline instruction set runs the wider kernels where
+ * they are available. The environment variable COMPENSATED_ISA, set to
+ * "baseline", "avx2" or "avx512", selects a lower variant, e.g., for
+ * benchmarking. Since the variants sum in different orders, their results
+ * may differ in the last bits.
+ */
+#if defined(COMPENSATED_DISPATCH) && defined(__GNUC__) && defined(__x86_64__)
+#define COMPENSATED_RUNTIME_DISPATCH
+#endif
+
+/*
+ * Under runtime dispatch, the kernels and every helper they call are forced
+ * inline, so that each variant is compiled as a whole for its instruction set
+ * at any optimization level, and never calls an out-of-line copy compiled for
+ * another one (which the linker could pick from any translation unit).
+ */
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+#define COMPENSATED_KERNEL_INLINE __attribute__((always_inline))
+#else
+#define COMPENSATED_KERNEL_INLINE
+#endif
 
 namespace compensated
 {
@@ -56,6 +171,10 @@ namespace compensated
  * can use Neumaier's algorithm which improves on Kahan's.
  * The improved (Kahan-Neumaier) algorithm keeps the running compensation
  * small by cancelling values of more similar orders of magnitude.
+ *
+ * These defaults can be overridden with the second template parameter
+ * of `value`, which selects one of the algorithms listed in the enum
+ * `algorithm` below.
  */
 
 /**
@@ -103,12 +222,31 @@ concept has_custom_abs = requires(T a)
     {a.abs()} -> std::three_way_comparable;
 };
 
+/**
+ * @brief Whether the type is a 16-bit floating-point type: `_Float16`, or
+ * the C++23 `std::float16_t` and `std::bfloat16_t` when they are available.
+ * These types are neither recognized by std::is_floating_point nor
+ * supported by std::abs in every standard library.
+ */
+template<typename T>
+concept is_half_precision = false
+#if defined(__FLT16_MAX__)
+                          || std::same_as<T, _Float16>
+#endif
+#if defined(__STDCPP_FLOAT16_T__)
+                          || std::same_as<T, std::float16_t>
+#endif
+#if defined(__STDCPP_BFLOAT16_T__)
+                          || std::same_as<T, std::bfloat16_t>
+#endif
+                          ;
+
 /**
  * @brief Whether the type represents a real number
  */
 template<typename T>
 concept is_real = std::three_way_comparable<T>
-                  && (has_std_abs<T> || has_custom_abs<T>);
+                  && (has_std_abs<T> || has_custom_abs<T> || is_half_precision<T>);
 
 /*
  * Formulate a predicate saying that a given type behaves
@@ -132,6 +270,15 @@ concept is_complex = requires(T z)
     z = T(z.real(), z.imag()); // Can be reconstructed from those
 };
 
+/**
+ * @brief Whether the type is a complex number with floating-point parts
+ */
+template<typename T>
+concept is_floating_complex = is_complex<T> && requires(T z)
+{
+    {z.real()} -> std::floating_point;
+};
+
 /**
  * @brief The concept of an iterator to a container with
  * elements of raw value type in it.
@@ -144,6 +291,66 @@ concept is_iterator_to = requires (It i, It j)
     {i = ++j}; // can be incremented
 };
 
+/**
+ * @brief The concept of a range (a container or a view) with elements of
+ * raw value type in it.
+ */
+template<typename R, typename V>
+concept is_range_of = std::ranges::input_range<R>
+                    && std::convertible_to<std::ranges::range_reference_t<R>, V>;
+
+/**
+ * @brief The concept of a floating-point type for which a vectorized
+ * summation kernel exists, so that values of it gathered in a buffer can be
+ * summed by the kernel.
+ */
+template<typename V>
+concept is_vector_summable = std::same_as<V, float> || std::same_as<V, double>;
+
+/**
+ * @brief The concept of an iterator to contiguous storage of raw values
+ * of a floating-point type for which a vectorized summation kernel exists.
+ */
+template<typename It, typename V>
+concept is_contiguous_iterator_to = std::contiguous_iterator<It>
+                                  && std::same_as<std::iter_value_t<It>, V>
+                                  && is_vector_summable<V>;
+
+/**
+ * @brief The concept of an iterator to contiguous storage of raw values
+ * of another arithmetic type (such as integers, 16-bit floats, or floats for
+ * a sum of doubles), which the vectorized summation kernels convert as they
+ * load them.
+ */
+template<typename It, typename V>
+concept is_contiguous_convertible_iterator_to = std::contiguous_iterator<It>
+                                              && is_vector_summable<V>
+                                              && (!std::same_as<std::iter_value_t<It>, V>)
+                                              && (std::same_as<std::iter_value_t<It>, float>
+                                                  || std::same_as<std::iter_value_t<It>, double>
+                                                  || is_half_precision<std::iter_value_t<It>>
+                                                  || (std::integral<std::iter_value_t<It>>
+                                                      && !std::same_as<std::iter_value_t<It>, bool>));
+
+/**
+ * @brief The concept of an iterator to contiguous storage of std::complex
+ * numbers with floating-point parts, for which vectorized kernels exist.
+ */
+template<typename It, typename V>
+concept is_contiguous_complex_iterator_to = std::contiguous_iterator<It>
+                                          && std::same_as<std::iter_value_t<It>, V>
+                                          && (std::same_as<V, std::complex<float>>
+                                              || std::same_as<V, std::complex<double>>);
+
+/**
+ * @brief Whether the type can be multiplied as well as added
+ */
+template<typename T>
+concept ring_element = group_element<T> && requires(T a, T b)
+{
+    {a * b} -> std::convertible_to<T>;
+};
+
 /**
  * @brief The concept of the existence of an overload of
  * std::ostream::operator<< for the raw value type.
@@ -154,413 +361,5154 @@ concept has_output_operator = requires(std::ostream o, V v)
     {o << v} -> std::convertible_to<std::ostream&>;
 };
 //=============================================================================================
+/*
+ * Error-free transformations.
+ *
+ * An error-free transformation turns the result of a floating-point
+ * operation into a pair (result, error) such that the exact mathematical
+ * result equals result + error.
+ */
+
 /**
- * @mainclass
- * class `value` - template class representing a value
- * with compensated Kahan/Kahan-Neumaier addition.
- * @param
- * The template parameter is the underlying "raw" value type.
+ * @brief Knuth's branch-free TwoSum transformation
+ * @return the pair (fl(a + b), rounding error of the addition)
+ *
+ * Unlike the Kahan-Neumaier update, TwoSum does not compare magnitudes,
+ * so it costs six additions but no data-dependent branch. For types with
+ * componentwise addition (such as std::complex), it acts on each component.
  */
-template<kahanizable V>
-class value
+template<typename T>
+requires group_element<T>
+COMPENSATED_KERNEL_INLINE
+inline constexpr std::pair<T, T> two_sum(const T& a, const T& b)
 {
-private:
-    V Sum = 0;           // the sum
-    V Compensation = 0;  // the running compensation
+    T sum = a + b;
+    T virtual_b = sum - a;
+    T virtual_a = sum - virtual_b;
+    return {sum, (a - virtual_a) + (b - virtual_b)};
+}
 
-public:
-    // Constructors from nothing and from V:
-    constexpr value() = default;
-    explicit constexpr value(const V& initial_value)
-        : Sum{initial_value}
-    {
-        Compensation = 0;
-    }
-    /*
-     * Copy/move constructors and assignment operators: all defaulted.
-     * This class is default-constructible, trivially copiable and movable
-     */
-    ~value() = default;
+/**
+ * @brief Dekker's FastTwoSum transformation, valid when the exponent
+ * of `a` is not smaller than that of `b` (e.g., when |a| >= |b|)
+ * @return the pair (fl(a + b), rounding error of the addition)
+ *
+ * It costs three additions, and is used to renormalize pairs whose
+ * ordering is already known.
+ */
+template<typename T>
+requires group_element<T>
+inline constexpr std::pair<T, T> fast_two_sum(const T& a, const T& b)
+{
+    T sum = a + b;
+    return {sum, b - (sum - a)};
+}
 
-private:
-    // Constructor which manually sets the members. For internal use only.
-    explicit constexpr value(V S, V C) : Sum{S}, Compensation{C} {};
+/**
+ * @brief The TwoProd transformation, computed with a fused multiply-add
+ * @return the pair (fl(a * b), rounding error of the multiplication)
+ *
+ * The error is exact unless the product underflows. Without hardware
+ * FMA support, std::fma falls back to a (much slower) library routine.
+ */
+template<std::floating_point T>
+inline std::pair<T, T> two_prod(T a, T b)
+{
+    T product = a * b;
+    return {product, std::fma(a, b, -product)};
+}
 
-public:
-//=== Conversion operators ===
+/**
+ * @brief The choice of the compensated summation algorithm
+ */
+enum class algorithm
+{
+    naive,    // no compensation at all, added in order, for reference measurements
+    kahan,    // plain Kahan summation
+    neumaier, // Kahan-Neumaier: cancels the larger of the two summands
+    two_sum,  // Knuth's branch-free TwoSum, same results as Kahan-Neumaier
+    klein     // Klein's second-order Kahan-Babuska: compensates the compensation
+};
 
-    /**
-     * @brief Conversion operator to the raw value type
-     */
-    inline constexpr operator V() const {return Sum + Compensation;}
+/**
+ * @brief The algorithm used when none is specified: Kahan-Neumaier
+ * for real and complex types, plain Kahan for other types
+ */
+template<typename V>
+inline constexpr algorithm default_algorithm = (is_real<V> || is_complex<V>)
+                                             ? algorithm::neumaier
+                                             : algorithm::kahan;
 
-    /**
-     * @brief Assignment operator from raw value type
-     */
-    inline void operator= (V value)
-    {
-        Sum = value;
-        Compensation = 0;
-    }
+/**
+ * @brief Whether the algorithm A can be used with the raw value type V
+ */
+template<typename V, algorithm A>
+concept supports_algorithm = (A != algorithm::neumaier) || is_real<V> || is_complex<V>;
 
-    /**
-     * @brief Provides an estimate of the error resulting from conversion
-     * to the raw value type
-     */
-    inline V error(void) const
-    {
-        V converted = V(*this);
-        return (Sum - converted) + Compensation;
-    }
+/**
+ * @brief The instruction sets for which the vectorized kernels are compiled
+ * under runtime dispatch (see COMPENSATED_DISPATCH)
+ */
+enum class instruction_set
+{
+    baseline, // as enabled for the translation unit (e.g., SSE2)
+    avx2,     // AVX2 with FMA (Haswell, Zen and later)
+    avx512    // AVX-512F (Skylake-X, Zen 4 and later)
+};
 
-    /**
-     * @brief Extracts the real part of a complex value
-     */
-    inline constexpr auto real(void) const
-    requires is_complex<V>
+/**
+ * @brief The instruction set of the vectorized kernels in use: under runtime
+ * dispatch, the best one supported by the processor, unless a lower one is
+ * requested in the environment variable COMPENSATED_ISA; otherwise, always
+ * the baseline. The choice is made once per process.
+ */
+inline instruction_set kernel_instruction_set()
+{
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+    static const instruction_set selected = []
     {
-        return Sum.real() + Compensation.real();
-    }
+        __builtin_cpu_init();
+        instruction_set supported = instruction_set::baseline;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            supported = instruction_set::avx2;
+            if (__builtin_cpu_supports("avx512f"))
+                supported = instruction_set::avx512;
+        }
 
-    /**
-     * @brief Extracts the imaginary part of a complex value
-     */
-    inline constexpr auto imag(void) const
-    requires is_complex<V>
-    {
-        return Sum.imag() + Compensation.imag();
-    }
+        const char* requested = std::getenv("COMPENSATED_ISA");
+        if (requested == nullptr)
+            return supported;
+        else if (std::strcmp(requested, "baseline") == 0)
+            return instruction_set::baseline;
+        else if (std::strcmp(requested, "avx2") == 0)
+            return std::min(supported, instruction_set::avx2);
+        else // "avx512", or an unknown name
+            return supported;
+    }();
+    return selected;
+#else
+    return instruction_set::baseline;
+#endif
+}
+//=============================================================================================
+/*
+ * Internal helpers: vectorized bulk summation kernels.
+ *
+ * The kernels run several independent Kahan-Neumaier accumulators ("lanes")
+ * side by side. On GCC and Clang, the lanes are packed into generic vector
+ * types, which the compiler maps onto SSE2/AVX/AVX-512 registers, as enabled
+ * for the translation unit. Elsewhere, a plain array of lanes is used.
+ */
+namespace detail
+{
+// Request full unrolling of short loops over vector registers:
+#if defined(__clang__)
+#define COMPENSATED_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define COMPENSATED_UNROLL _Pragma("GCC unroll 16")
+#else
+#define COMPENSATED_UNROLL
+#endif
 
-//=== Equality comparison operators ===
-// Note: the corresponding `!=` operators will be auto-generated
-// by the C++20 rewriting mechanism.
+/*
+ * GCC warns that packs wider than the vector registers of the translation
+ * unit are passed differently between functions (-Wpsabi), which does not
+ * matter for the inlined helpers. Some of these diagnostics are, however,
+ * reported at the end of the translation unit or as notes, which this
+ * region does not silence. Therefore, the helpers reached by the wider
+ * variants of runtime dispatch take packs by reference, and return them
+ * in reference parameters.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
-    /**
-     * @brief operator== tries to determine if two objects represent the
-     * same mathematical value, even if represented differently
-     * @param other - right-hand side of comparison
-     * @return true on equality, false on inequality
-     */
-    inline constexpr bool operator== (const value<V>& other) const
-    requires std::equality_comparable<V>
+#if defined(__GNUC__)
+/**
+ * @brief A bundle of W lanes of type T, held in a single vector register
+ */
+template<typename T, std::size_t W>
+struct pack_of
+{
+    typedef T type __attribute__((vector_size(W * sizeof(T))));
+};
+#else
+/**
+ * @brief A bundle of W lanes of type T, emulated with an array
+ */
+template<typename T, std::size_t W>
+struct lane_array
+{
+    T lane[W];
+
+    inline constexpr T& operator[] (std::size_t k) {return lane[k];}
+    inline constexpr const T& operator[] (std::size_t k) const {return lane[k];}
+
+    inline constexpr lane_array operator+ (const lane_array& other) const
     {
-        return (Sum - other.Sum == other.Compensation - Compensation);
+        lane_array result;
+        for (std::size_t k = 0; k < W; k++)
+            result.lane[k] = lane[k] + other.lane[k];
+        return result;
     }
 
-    /**
-     * @brief operator== tries to compare the value represented by this
-     * object with a raw value
-     * @param value - raw value to compare with
-     * @return true on equality, false on inequality
-     */
-    inline constexpr bool operator== (const V& value) const
-    requires std::equality_comparable<V>
+    inline constexpr lane_array operator- (const lane_array& other) const
     {
-        return (Compensation == value - Sum) || (Sum == value - Compensation);
+        lane_array result;
+        for (std::size_t k = 0; k < W; k++)
+            result.lane[k] = lane[k] - other.lane[k];
+        return result;
     }
 
-//=== Unary minus ===
-    /**
-     * @brief Unary minus - for raw value types possessing a unary minus
-     */
-    inline constexpr value<V> operator- (void) const
-    requires has_unary_minus<V>
+    inline constexpr lane_array operator* (const lane_array& other) const
     {
-        return value<V>(-Sum, -Compensation);
+        lane_array result;
+        for (std::size_t k = 0; k < W; k++)
+            result.lane[k] = lane[k] * other.lane[k];
+        return result;
     }
 
-    /**
-     * @brief Unary minus - for raw value types without a unary minus
-     */
-    inline constexpr value<V> operator- (void) const
-    requires (! has_unary_minus<V>)
+    inline constexpr lane_array& operator+= (const lane_array& other)
     {
-        V zero = 0;
-        // We use subtraction from zero since there is no unary minus for V
-        return value<V>(zero - Sum, zero - Compensation);
+        return *this = *this + other;
     }
 
-// === Kahan-Neumaier summation operators (on the right) ===
-// --- Real case ---
-    /**
-     * @brief Add an element of type V using the Kahan-Neumaier addition
-     * (real case supported by std::abs)
-     */
-    inline value<V> operator+ (const V& increment) const
-    requires is_real<V> && has_std_abs<V>
+    inline constexpr lane_array& operator-= (const lane_array& other)
     {
-        V naive_sum = Sum + increment;
-        if (std::abs(Sum) > std::abs(increment))
-        {
-            /* In this case, we have a large sum to which a small increment
-             * is added. Therefore, the compensation is computed by cancelling
-             * the large sum with the naive sum.
-             */
-            return value<V>(naive_sum,
-                            Compensation + ((Sum - naive_sum) + increment));
-        }
-        else
-        {
-            /* In this case, the roles swap: the increment is larger than
-             * the old sum, so we use the increment for the cancellation.
-             */
-            return value<V>(naive_sum,
-                            Compensation + ((increment - naive_sum) + Sum));
-        }
+        return *this = *this - other;
     }
+};
 
-    /**
-     * @brief Add an element of type V using the Kahan-Neumaier addition
-     * (real case with user-supplied abs() member)
-     */
-    inline value<V> operator+ (const V& increment) const
-    requires is_real<V> && has_custom_abs<V> && (!has_std_abs<V>)
-    { // See comments for the version with std::abs for explanation
-        V naive_sum = Sum + increment;
-        if (Sum.abs() > increment.abs())
-            return value<V>(naive_sum,
-                            Compensation + ((Sum - naive_sum) + increment));
-        else
-            return value<V>(naive_sum,
-                            Compensation + ((increment - naive_sum) + Sum));
-    }
+template<typename T, std::size_t W>
+struct pack_of
+{
+    using type = lane_array<T, W>;
+};
+#endif
 
-    /**
-     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
-     * (real case supported by std::abs)
-     */
-    inline void operator+= (const V& increment)
-    requires is_real<V> && has_std_abs<V>
-    {
-        V naive_sum = Sum + increment;
-        if (std::abs(Sum) > std::abs(increment)) // See comments in operator+
-            Compensation = Compensation + ((Sum - naive_sum) + increment);
+template<typename T, std::size_t W>
+using pack = typename pack_of<T, W>::type;
+
+/**
+ * @brief Number of lanes of type T fitting in a vector register of the given size
+ */
+template<typename T, std::size_t bytes>
+inline constexpr std::size_t lanes_in = (bytes >= sizeof(T)) ? bytes / sizeof(T) : 1;
+
+/**
+ * @brief Number of lanes of type T fitting in one vector register
+ */
+template<typename T>
+inline constexpr std::size_t native_lanes = lanes_in<T, COMPENSATED_VECTOR_BYTES>;
+
+/**
+ * @brief The absolute value of a real number, also for the 16-bit
+ * floating-point types, which are measured as floats
+ */
+template<typename T>
+inline auto magnitude(const T& x)
+{
+    if constexpr (is_half_precision<T>)
+        return std::abs(static_cast<float>(x));
+    else
+        return std::abs(x);
+}
+
+/**
+ * @brief Returns W copies of the value `x`
+ */
+template<typename T, std::size_t W>
+COMPENSATED_KERNEL_INLINE
+inline pack<T, W> broadcast(T x)
+{
+    pack<T, W> result;
+    for (std::size_t k = 0; k < W; k++)
+        result[k] = x;
+    return result;
+}
+
+/**
+ * @brief Loads W consecutive values into `result`, with no alignment requirement
+ */
+template<typename T, std::size_t W>
+COMPENSATED_KERNEL_INLINE
+inline void load(const T* source, pack<T, W>& result)
+{
+    std::memcpy(&result, source, sizeof(result));
+}
+
+#if defined(__GNUC__)
+/**
+ * @brief Loads W consecutive 16-bit floating-point values and widens them
+ * to floats. The compilers convert vectors of such values element by element,
+ * so bfloat16 values are widened as the upper halves of floats, and IEEE
+ * binary16 values with the F16C instructions, or else with integer operations.
+ * (The built-in bit cast is used, since std::bit_cast returns the wider packs
+ * of the dispatched kernels by value.)
+ */
+template<std::size_t W, typename N>
+COMPENSATED_KERNEL_INLINE
+inline void load_half(const N* source, pack<float, W>& result)
+{
+    using bits = pack<std::uint32_t, W>;
+    using halves = pack<std::uint16_t, W>;
+    const auto* raw = reinterpret_cast<const std::uint16_t*>(source);
+    halves h;
+    load<std::uint16_t, W>(raw, h);
+#if defined(__STDCPP_BFLOAT16_T__)
+    if constexpr (std::same_as<N, std::bfloat16_t>)
+    {
+        result = __builtin_bit_cast(pack<float, W>, __builtin_convertvector(h, bits) << 16);
+        return;
+    }
+#endif
+#if defined(__F16C__)
+    if constexpr (W == 4)
+    {
+        result = __builtin_bit_cast(pack<float, W>, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(raw))));
+        return;
+    }
+#if defined(__AVX__)
+    if constexpr (W == 8)
+    {
+        result = __builtin_bit_cast(pack<float, W>, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw))));
+        return;
+    }
+#endif
+#if defined(__AVX512F__)
+    // (The zero-masked form, since _mm512_cvtph_ps() trips -Wuninitialized in GCC 12)
+    if constexpr (W == 16)
+    {
+        result = __builtin_bit_cast(pack<float, W>, _mm512_maskz_cvtph_ps(0xffff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw))));
+        return;
+    }
+#endif
+#endif
+    bits widened_h = __builtin_convertvector(h, bits);
+    bits unsigned_bits = (widened_h & 0x7fffu) << 13;
+    // Scaling by 2^112 rebiases the exponent of the normal and subnormal values:
+    bits scaled = __builtin_bit_cast(bits, __builtin_bit_cast(pack<float, W>, unsigned_bits) * 0x1p112f);
+    // Infinities and NaNs keep the largest exponent:
+    bits widened = (unsigned_bits >= 0x0f800000u) ? (unsigned_bits | 0x7f800000u) : scaled;
+    result = __builtin_bit_cast(pack<float, W>, widened | (widened_h & 0x8000u) << 16);
+}
+#endif
+
+/**
+ * @brief Loads W consecutive values of type N into the lanes of type T of
+ * `result`, with no alignment requirement, converting them (e.g., floats to
+ * doubles with a single cvtps2pd instruction)
+ */
+template<typename T, std::size_t W, typename N>
+COMPENSATED_KERNEL_INLINE
+inline void load_converted(const N* source, pack<T, W>& result)
+{
+    if constexpr (std::same_as<T, N>)
+        load<T, W>(source, result);
+#if defined(__GNUC__)
+    else if constexpr (is_half_precision<N>)
+    {
+        pack<float, W> widened;
+        load_half<W>(source, widened);
+        result = __builtin_convertvector(widened, pack<T, W>);
+    }
+#endif
+    else
+    {
+#if defined(__GNUC__)
+        pack<N, W> raw;
+        load<N, W>(source, raw);
+        result = __builtin_convertvector(raw, pack<T, W>);
+#else
+        for (std::size_t k = 0; k < W; k++)
+            result[k] = static_cast<T>(source[k]);
+#endif
+    }
+}
+
+/**
+ * @brief Stores W values to consecutive locations, with no alignment requirement
+ */
+template<typename T, std::size_t W>
+inline void store(T* destination, const pack<T, W>& values)
+{
+    std::memcpy(destination, &values, sizeof(values));
+}
+
+/**
+ * @brief A minimal allocator returning storage aligned to `Alignment` bytes
+ */
+template<typename T, std::size_t Alignment = 64>
+struct aligned_allocator
+{
+    using value_type = T;
+    template<typename U>
+    struct rebind {using other = aligned_allocator<U, Alignment>;};
+
+    constexpr aligned_allocator() noexcept = default;
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+    inline T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    inline void deallocate(T* pointer, std::size_t) noexcept
+    {
+        ::operator delete(pointer, std::align_val_t{Alignment});
+    }
+
+    template<typename U>
+    inline constexpr bool operator== (const aligned_allocator<U, Alignment>&) const noexcept
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief Number of elements of a lazy range (such as a view) which are
+ * copied at a time into a buffer on the stack, to be summed by the
+ * vectorized kernels. The buffer is small enough to stay in the L1 cache.
+ */
+inline constexpr std::size_t buffer_chunk_size = 256;
+
+/**
+ * @brief Number of elements in each of the chunks into which a range is
+ * split when it is summed under a parallel execution policy. The chunks
+ * do not depend on the number of threads, so neither does the result.
+ */
+inline constexpr std::size_t parallel_chunk_size = std::size_t{1} << 16;
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @brief The indices 0, 1, ... of the chunks of a range of `count` elements,
+ * over which the parallel algorithms iterate
+ */
+inline std::vector<std::size_t> chunk_indices(std::size_t count)
+{
+    std::vector<std::size_t> indices((count + parallel_chunk_size - 1) / parallel_chunk_size);
+    std::iota(indices.begin(), indices.end(), std::size_t{0});
+    return indices;
+}
+
+/**
+ * @brief Sums a random-access range into `accumulator` under an execution
+ * policy: each chunk of the range is summed into its own accumulator,
+ * and the partial results are then added to `accumulator` in order.
+ */
+template<typename Accumulator, typename ExecutionPolicy, typename It>
+inline void parallel_accumulate(Accumulator& accumulator, ExecutionPolicy&& policy,
+                                It first, It last)
+{
+    const auto count = static_cast<std::size_t>(last - first);
+    const std::vector<std::size_t> chunks = chunk_indices(count);
+    std::vector<Accumulator> partial(chunks.size());
+    std::for_each(std::forward<ExecutionPolicy>(policy),
+                  chunks.begin(), chunks.end(),
+                  [&partial, first, count](std::size_t k)
+                  {
+                      const auto begin = k * parallel_chunk_size;
+                      const auto end = std::min(count, begin + parallel_chunk_size);
+                      partial[k].accumulate(first + begin, first + end);
+                  });
+    for (const auto& p : partial)
+        accumulator += p;
+}
+
+/**
+ * @brief Computes the prefix sums of a random-access range under an
+ * execution policy, in two passes over fixed chunks: first, the sum of
+ * each chunk is computed; then, each chunk is scanned starting from the
+ * sum of `init` and all the preceding chunks.
+ * @param inclusive - whether the i-th output includes the i-th element
+ * @return the iterator past the last output
+ */
+template<typename Accumulator, typename ExecutionPolicy, typename It, typename Out>
+inline Out parallel_scan(ExecutionPolicy&& policy, It first, It last, Out out,
+                         Accumulator init, bool inclusive)
+{
+    const auto count = static_cast<std::size_t>(last - first);
+    const std::vector<std::size_t> chunks = chunk_indices(count);
+    std::vector<Accumulator> offset(chunks.size());
+
+    std::for_each(policy, chunks.begin(), chunks.end(),
+                  [first, count, &offset](std::size_t k)
+                  {
+                      const auto begin = k * parallel_chunk_size;
+                      const auto end = std::min(count, begin + parallel_chunk_size);
+                      offset[k].accumulate(first + begin, first + end);
+                  });
+
+    // Turn the chunk sums into the sums of everything before each chunk:
+    Accumulator running = init;
+    for (auto& chunk_sum : offset)
+    {
+        const Accumulator previous = running;
+        running += chunk_sum;
+        chunk_sum = previous;
+    }
+
+    std::for_each(policy, chunks.begin(), chunks.end(),
+                  [first, out, count, inclusive, &offset](std::size_t k)
+                  {
+                      const auto begin = k * parallel_chunk_size;
+                      const auto end = std::min(count, begin + parallel_chunk_size);
+                      Accumulator partial = offset[k];
+                      for (auto i = begin; i < end; i++)
+                      {
+                          const auto x = first[i]; // read first, for in-place scans
+                          if (inclusive)
+                              partial += x;
+                          out[i] = partial;
+                          if (!inclusive)
+                              partial += x;
+                      }
+                  });
+    return out + count;
+}
+#endif
+
+/**
+ * @brief Adds `x` to the pair (`sum`, `compensation`) using the branch-free
+ * TwoSum transformation, which yields the same rounding error as the
+ * Kahan-Neumaier comparison of magnitudes.
+ */
+template<typename T>
+COMPENSATED_KERNEL_INLINE
+inline void two_sum_step(T& sum, T& compensation, T x)
+{
+    auto [naive_sum, error] = two_sum(sum, x);
+    compensation += error;
+    sum = naive_sum;
+}
+
+/**
+ * @brief Merges U packs of W lanes of sums and compensations into
+ * the pair (`sum`, `compensation`)
+ */
+template<typename T, std::size_t W, std::size_t U>
+COMPENSATED_KERNEL_INLINE
+inline void merge_lanes(const pack<T, W> (&sums)[U], const pack<T, W> (&comps)[U],
+                        T& sum, T& compensation)
+{
+    for (std::size_t u = 0; u < U; u++)
+        for (std::size_t k = 0; k < W; k++)
+        {
+            two_sum_step(sum, compensation, sums[u][k]);
+            compensation += comps[u][k];
+        }
+}
+
+/**
+ * @brief The running sums and compensations of the lanes of the summation
+ * kernel: U packs of W lanes, which hide the latency of the floating-point
+ * adder. Each of the W*U lanes carries its own sum and compensation,
+ * and the lanes are merged with compensation at the end.
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 4>
+struct lane_sums
+{
+    using P = pack<T, W>;
+    static constexpr std::size_t block = U * W;
+
+    P sums[U] = {};
+    P comps[U] = {};
+
+    /**
+     * @brief Adds the longest prefix of the data which consists of whole blocks.
+     * The data may be of a narrower type N, converted to T as it is loaded.
+     * @return the number of values added
+     */
+    template<typename N = T>
+    COMPENSATED_KERNEL_INLINE
+    inline std::size_t add_blocks(const N* data, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + block <= count; i += block)
+        {
+            COMPENSATED_UNROLL
+            for (std::size_t u = 0; u < U; u++)
+            {   // Vectorized TwoSum:
+                P x;
+                load_converted<T, W>(data + i + u*W, x);
+                P naive_sum = sums[u] + x;
+                P virtual_x = naive_sum - sums[u];
+                comps[u] += (sums[u] - (naive_sum - virtual_x)) + (x - virtual_x);
+                sums[u] = naive_sum;
+            }
+        }
+        return i;
+    }
+
+    /**
+     * @brief Merges the lanes into the pair (`sum`, `compensation`)
+     */
+    COMPENSATED_KERNEL_INLINE
+    inline void merge(T& sum, T& compensation) const
+    {
+        merge_lanes<T, W, U>(sums, comps, sum, compensation);
+    }
+};
+
+/**
+ * @brief Compensated sum of `count` contiguous values.
+ * @param data - pointer to the first value
+ * @param count - number of values to sum
+ * @param sum - receives the sum
+ * @param compensation - receives the running compensation
+ *
+ * The template parameter W is the number of lanes per vector register
+ * and U is the number of registers processed in each iteration,
+ * as in lane_sums.
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 4>
+COMPENSATED_KERNEL_INLINE
+inline void sum_kernel(const T* data, std::size_t count, T& sum, T& compensation)
+{
+    lane_sums<T, W, U> lanes;
+    const std::size_t i = lanes.add_blocks(data, count);
+
+    // Merge the lanes
+    T S = 0;
+    T C = 0;
+    lanes.merge(S, C);
+
+    // Process the remaining elements
+    for (const T* tail = data + i; tail != data + count; ++tail)
+        two_sum_step(S, C, *tail);
+
+    sum = S;
+    compensation = C;
+}
+
+/**
+ * @brief Sum of `count` contiguous values of an arithmetic type N, such as
+ * float or std::int64_t, accumulated in the type T, such as double. The values
+ * are converted to T as they are loaded. With `compensated` set, the lanes are compensated
+ * as in sum_kernel(); otherwise, they hold plain sums, and the compensation
+ * is zero.
+ */
+template<typename T, typename N, bool compensated,
+         std::size_t W = native_lanes<T>, std::size_t U = 4>
+COMPENSATED_KERNEL_INLINE
+inline void converting_sum_kernel(const N* data, std::size_t count, T& sum, T& compensation)
+{
+    T S = 0;
+    T C = 0;
+    std::size_t i = 0;
+    if constexpr (compensated)
+    {
+        lane_sums<T, W, U> lanes;
+        i = lanes.add_blocks(data, count);
+        lanes.merge(S, C);
+        for (; i < count; i++)
+            two_sum_step(S, C, static_cast<T>(data[i]));
+    }
+    else
+    {
+        using P = pack<T, W>;
+        P sums[U] = {};
+        for (; i + U*W <= count; i += U*W)
+        {
+            COMPENSATED_UNROLL
+            for (std::size_t u = 0; u < U; u++)
+            {
+                P x;
+                load_converted<T, W>(data + i + u*W, x);
+                sums[u] += x;
+            }
+        }
+        for (std::size_t u = 0; u < U; u++)
+            for (std::size_t k = 0; k < W; k++)
+                S += sums[u][k];
+        for (; i < count; i++)
+            S += static_cast<T>(data[i]);
+    }
+    sum = S;
+    compensation = C;
+}
+
+/*
+ * Whether the target has hardware fused multiply-add. Without it, std::fma
+ * is a slow library routine, and the kernels use Dekker's product instead.
+ */
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+inline constexpr bool hardware_fma = true;
+#else
+inline constexpr bool hardware_fma = false;
+#endif
+
+/**
+ * @brief Veltkamp's splitting constant 2^ceil(p/2) + 1 for precision p
+ */
+template<std::floating_point T>
+inline constexpr T splitter = T((std::uint64_t{1} << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+
+/**
+ * @brief Dekker's product error: the rounding error of `product` = fl(a * b),
+ * computed by splitting the factors in halves with Veltkamp's method,
+ * for scalars or for packs of lanes. It is exact unless a factor is
+ * so large (about 2^996 for doubles) that the splitting overflows.
+ */
+template<typename X, typename T>
+COMPENSATED_KERNEL_INLINE
+inline X dekker_product_error(X a, X b, X product, T split)
+{
+    X a_scaled = a * split;
+    X a_high = a_scaled - (a_scaled - a);
+    X a_low = a - a_high;
+    X b_scaled = b * split;
+    X b_high = b_scaled - (b_scaled - b);
+    X b_low = b - b_high;
+    return (((a_high * b_high - product) + a_high * b_low) + a_low * b_high) + a_low * b_low;
+}
+
+/**
+ * @brief The rounding error of `product` = fl(a * b)
+ */
+template<std::floating_point T, bool fused = hardware_fma>
+COMPENSATED_KERNEL_INLINE
+inline T product_error(T a, T b, T product)
+{
+    if constexpr (fused)
+        return std::fma(a, b, -product);
+    else
+        return dekker_product_error(a, b, product, splitter<T>);
+}
+
+/**
+ * @brief Stores in `error` the rounding errors of the lane-wise products
+ * `product` = fl(a * b)
+ */
+template<std::floating_point T, std::size_t W, bool fused = hardware_fma>
+COMPENSATED_KERNEL_INLINE
+inline void lanes_product_error(const pack<T, W>& a, const pack<T, W>& b,
+                                const pack<T, W>& product, pack<T, W>& error)
+{
+    if constexpr (fused)
+    {   // Compilers turn this loop into a single vector FMA instruction
+        COMPENSATED_UNROLL
+        for (std::size_t k = 0; k < W; k++)
+            error[k] = std::fma(a[k], b[k], -product[k]);
+    }
+    else
+        error = dekker_product_error(a, b, product, broadcast<T, W>(splitter<T>));
+}
+
+/**
+ * @brief Vectorized TwoSum: adds the lanes of `x` to the lanes of `sum`,
+ * and their rounding errors plus `extra` to the lanes of `compensation`
+ */
+template<typename P>
+COMPENSATED_KERNEL_INLINE
+inline void lanes_two_sum(P& sum, P& compensation, const P& x, const P& extra)
+{
+    P naive_sum = sum + x;
+    P virtual_x = naive_sum - sum;
+    compensation += ((sum - (naive_sum - virtual_x)) + (x - virtual_x)) + extra;
+    sum = naive_sum;
+}
+
+/**
+ * @brief Compensated dot product of `count` contiguous pairs of values,
+ * after Ogita, Rump and Oishi's Dot2: each product is split into its
+ * rounded value and its rounding error with TwoProd, the rounded values
+ * are summed with TwoSum, and all errors go to the compensation.
+ * @param x, y - pointers to the first values of the factors
+ * @param count - number of products to sum
+ * @param sum - receives the sum
+ * @param compensation - receives the running compensation
+ *
+ * The lanes are organized as in sum_kernel().
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 4,
+         bool fused = hardware_fma>
+COMPENSATED_KERNEL_INLINE
+inline void dot_kernel(const T* x, const T* y, std::size_t count, T& sum, T& compensation)
+{
+    using P = pack<T, W>;
+    P sums[U] = {};
+    P comps[U] = {};
+
+    std::size_t i = 0;
+    for (; i + U*W <= count; i += U*W)
+    {
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {
+            P a, b, error;
+            load<T, W>(x + i + u*W, a);
+            load<T, W>(y + i + u*W, b);
+            P product = a * b;
+            lanes_product_error<T, W, fused>(a, b, product, error);
+            lanes_two_sum(sums[u], comps[u], product, error);
+        }
+    }
+
+    T S = 0;
+    T C = 0;
+    merge_lanes<T, W, U>(sums, comps, S, C);
+
+    for (; i < count; i++)
+    {
+        T product = x[i] * y[i];
+        two_sum_step(S, C, product);
+        C += product_error<T, fused>(x[i], y[i], product);
+    }
+    sum = S;
+    compensation = C;
+}
+
+/**
+ * @brief Compensated dot product of `count` contiguous pairs of complex
+ * numbers, stored as interleaved real and imaginary parts.
+ *
+ * For each pair of lanes (a.re, a.im), (b.re, b.im), one set of accumulators
+ * collects the "direct" products (a.re b.re, a.im b.im), whose difference
+ * is the real part of ab, and another set collects the "cross" products
+ * (a.re b.im, a.im b.re), whose sum is the imaginary part of ab.
+ */
+template<typename T, std::size_t W = std::max<std::size_t>(2, native_lanes<T>),
+         std::size_t U = 2, bool fused = hardware_fma>
+COMPENSATED_KERNEL_INLINE
+inline void complex_dot_kernel(const std::complex<T>* x, const std::complex<T>* y,
+                               std::size_t count, std::complex<T>& sum,
+                               std::complex<T>& compensation)
+{
+    static_assert(W % 2 == 0, "The lanes must hold whole complex numbers");
+    using P = pack<T, W>;
+    // The standard guarantees that std::complex<T> is laid out as T[2]:
+    const T* a_parts = reinterpret_cast<const T*>(x);
+    const T* b_parts = reinterpret_cast<const T*>(y);
+    const std::size_t parts = 2 * count;
+
+    P direct_sums[U] = {}, direct_comps[U] = {};
+    P cross_sums[U] = {}, cross_comps[U] = {};
+    std::size_t i = 0;
+    for (; i + U*W <= parts; i += U*W)
+    {
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {
+            P a, b, b_swapped, error;
+            load<T, W>(a_parts + i + u*W, a);
+            load<T, W>(b_parts + i + u*W, b);
+            COMPENSATED_UNROLL
+            for (std::size_t k = 0; k < W; k++)
+                b_swapped[k] = b[k ^ 1];
+
+            P direct = a * b;
+            lanes_product_error<T, W, fused>(a, b, direct, error);
+            lanes_two_sum(direct_sums[u], direct_comps[u], direct, error);
+            P cross = a * b_swapped;
+            lanes_product_error<T, W, fused>(a, b_swapped, cross, error);
+            lanes_two_sum(cross_sums[u], cross_comps[u], cross, error);
+        }
+    }
+
+    // Merge the lanes: even lanes hold real parts, odd lanes imaginary parts
+    T real_sum = 0, real_comp = 0, imag_sum = 0, imag_comp = 0;
+    for (std::size_t u = 0; u < U; u++)
+        for (std::size_t k = 0; k < W; k += 2)
+        {
+            two_sum_step(real_sum, real_comp, direct_sums[u][k]);
+            two_sum_step(real_sum, real_comp, -direct_sums[u][k + 1]);
+            real_comp += direct_comps[u][k] - direct_comps[u][k + 1];
+            two_sum_step(imag_sum, imag_comp, cross_sums[u][k]);
+            two_sum_step(imag_sum, imag_comp, cross_sums[u][k + 1]);
+            imag_comp += cross_comps[u][k] + cross_comps[u][k + 1];
+        }
+
+    for (std::size_t n = i / 2; n < count; n++)
+    {
+        const T a_re = x[n].real(), a_im = x[n].imag();
+        const T b_re = y[n].real(), b_im = y[n].imag();
+        T products[4] = {a_re * b_re, -(a_im * b_im), a_re * b_im, a_im * b_re};
+        two_sum_step(real_sum, real_comp, products[0]);
+        two_sum_step(real_sum, real_comp, products[1]);
+        real_comp += product_error<T, fused>(a_re, b_re, products[0])
+                   - product_error<T, fused>(a_im, b_im, -products[1]);
+        two_sum_step(imag_sum, imag_comp, products[2]);
+        two_sum_step(imag_sum, imag_comp, products[3]);
+        imag_comp += product_error<T, fused>(a_re, b_im, products[2])
+                   + product_error<T, fused>(a_im, b_re, products[3]);
+    }
+    sum = std::complex<T>(real_sum, imag_sum);
+    compensation = std::complex<T>(real_comp, imag_comp);
+}
+
+/**
+ * @brief Compensated sum of `count` contiguous complex numbers, stored as
+ * interleaved real and imaginary parts.
+ *
+ * The parts are summed as in sum_kernel(), without deinterleaving them:
+ * since the number W of lanes is even, the even lanes accumulate the real
+ * parts and the odd lanes the imaginary parts, each with its own running
+ * compensation.
+ */
+template<typename T, std::size_t W = std::max<std::size_t>(2, native_lanes<T>), std::size_t U = 4>
+COMPENSATED_KERNEL_INLINE
+inline void complex_sum_kernel(const std::complex<T>* data, std::size_t count,
+                               std::complex<T>& sum, std::complex<T>& compensation)
+{
+    static_assert(W % 2 == 0, "The lanes must hold whole complex numbers");
+    // The standard guarantees that std::complex<T> is laid out as T[2]:
+    const T* parts = reinterpret_cast<const T*>(data);
+    lane_sums<T, W, U> lanes;
+    const std::size_t i = lanes.add_blocks(parts, 2 * count);
+
+    // Merge the lanes: even lanes hold real parts, odd lanes imaginary parts
+    T real_sum = 0, real_comp = 0, imag_sum = 0, imag_comp = 0;
+    for (std::size_t u = 0; u < U; u++)
+        for (std::size_t k = 0; k < W; k += 2)
+        {
+            two_sum_step(real_sum, real_comp, lanes.sums[u][k]);
+            real_comp += lanes.comps[u][k];
+            two_sum_step(imag_sum, imag_comp, lanes.sums[u][k + 1]);
+            imag_comp += lanes.comps[u][k + 1];
+        }
+
+    for (std::size_t n = i / 2; n < count; n++)
+    {
+        two_sum_step(real_sum, real_comp, data[n].real());
+        two_sum_step(imag_sum, imag_comp, data[n].imag());
+    }
+    sum = std::complex<T>(real_sum, imag_sum);
+    compensation = std::complex<T>(real_comp, imag_comp);
+}
+
+/**
+ * @brief Finds the largest magnitude among `count` doubles. NaNs are
+ * ignored, so the caller must check the finiteness of the result of
+ * whatever it computes from the data.
+ */
+inline double max_magnitude(const double* data, std::size_t count)
+{
+    constexpr auto magnitude_mask = static_cast<std::int64_t>(~(std::uint64_t{1} << 63));
+    double result = 0;
+    std::size_t i = 0;
+#if defined(__GNUC__)
+    constexpr std::size_t W = native_lanes<double>;
+    constexpr std::size_t U = 4;
+    using D = pack<double, W>;
+    using I = pack<std::int64_t, W>;
+    D lanes[U] = {};
+    for (; i + U*W <= count; i += U*W)
+    {
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {   // Clear the sign bits, then blend in the larger values:
+            D x;
+            load<double, W>(data + i + u*W, x);
+            x = (D) ((I) x & magnitude_mask);
+            I greater = x > lanes[u];
+            lanes[u] = (D) (((I) lanes[u] & ~greater) | ((I) x & greater));
+        }
+    }
+    for (std::size_t u = 0; u < U; u++)
+        for (std::size_t k = 0; k < W; k++)
+            result = std::max(result, static_cast<double>(lanes[u][k]));
+#endif
+    for (; i < count; i++)
+        result = std::max(result, std::abs(data[i]));
+    return result;
+}
+
+/**
+ * @brief Returns `c` as an X, which is either T itself or a pack of lanes of T
+ */
+template<typename T, typename X>
+inline X splat(T c)
+{
+    if constexpr (std::is_same_v<X, T>)
+        return c;
+    else
+        return broadcast<T, sizeof(X) / sizeof(T)>(c);
+}
+
+/**
+ * @brief The rounding error of `product` = fl(a * b), for scalars or packs
+ */
+template<typename T, typename X, bool fused>
+inline X any_product_error(X a, X b, X product)
+{
+    if constexpr (std::is_same_v<X, T>)
+        return product_error<T, fused>(a, b, product);
+    else
+    {
+        X error;
+        lanes_product_error<T, sizeof(X) / sizeof(T), fused>(a, b, product, error);
+        return error;
+    }
+}
+
+/**
+ * @brief TwoSum for scalars or packs: returns fl(a + b) and adds its
+ * rounding error to `error`
+ */
+template<typename X>
+inline X sum_with_error(X a, X b, X& error)
+{
+    X sum = a + b;
+    X virtual_b = sum - a;
+    error += (a - (sum - virtual_b)) + (b - virtual_b);
+    return sum;
+}
+
+/**
+ * @brief One step of the compensated Horner scheme of Graillat, Langlois
+ * and Louvet: (s, c) <- (s * x + coefficient, c * x + errors of the step)
+ */
+template<typename T, typename X, bool fused>
+inline void horner_step(X& s, X& c, X x, X coefficient)
+{
+    X product = s * x;
+    X error = any_product_error<T, X, fused>(s, x, product);
+    s = sum_with_error(product, coefficient, error);
+    c = c * x + error;
+}
+
+/**
+ * @brief One step of the compensated Clenshaw recurrence:
+ * b_k = coefficient + 2x b_{k+1} - b_{k+2}, where (b1, b2) hold
+ * (b_{k+1}, b_{k+2}), and the errors (e1, e2) follow the same recurrence,
+ * driven by the rounding errors of the step
+ */
+template<typename T, typename X, bool fused>
+inline void clenshaw_step(X& b1, X& b2, X& e1, X& e2, X two_x, X coefficient)
+{
+    X product = two_x * b1;
+    X error = any_product_error<T, X, fused>(two_x, b1, product);
+    X difference = sum_with_error(product, X{} - b2, error);
+    X b = sum_with_error(difference, coefficient, error);
+    X e = error + (two_x * e1 - e2);
+    b2 = b1;
+    b1 = b;
+    e2 = e1;
+    e1 = e;
+}
+
+/**
+ * @brief The last step of the compensated Clenshaw recurrence:
+ * coefficient + x b_1 - b_2, with the error terms
+ */
+template<typename T, typename X, bool fused>
+inline void clenshaw_last_step(X& sum, X& compensation, X b1, X b2, X e1, X e2,
+                               X x, X coefficient)
+{
+    X product = x * b1;
+    X error = any_product_error<T, X, fused>(x, b1, product);
+    X difference = sum_with_error(product, X{} - b2, error);
+    sum = sum_with_error(difference, coefficient, error);
+    compensation = error + (x * e1 - e2);
+}
+
+/**
+ * @brief Compensated Horner evaluation of the polynomial with coefficients
+ * [first, last), in ascending order of powers, at x (a scalar, or a pack of
+ * points). The result is the unevaluated sum `sum + compensation`.
+ */
+template<typename T, typename X, bool fused = hardware_fma, typename It>
+inline void horner_evaluate(It first, It last, X x, X& sum, X& compensation)
+{
+    X s{}, c{};
+    while (last != first)
+    {
+        --last;
+        horner_step<T, X, fused>(s, c, x, splat<T, X>(*last));
+    }
+    sum = s;
+    compensation = c;
+}
+
+/**
+ * @brief Compensated Clenshaw evaluation of the Chebyshev series with
+ * coefficients [first, last) at x (a scalar, or a pack of points).
+ * The result is the unevaluated sum `sum + compensation`.
+ */
+template<typename T, typename X, bool fused = hardware_fma, typename It>
+inline void clenshaw_evaluate(It first, It last, X x, X& sum, X& compensation)
+{
+    sum = X{};
+    compensation = X{};
+    if (first == last)
+        return;
+    X b1{}, b2{}, e1{}, e2{};
+    const X two_x = x + x;
+    while (--last != first)
+        clenshaw_step<T, X, fused>(b1, b2, e1, e2, two_x, splat<T, X>(*last));
+    clenshaw_last_step<T, X, fused>(sum, compensation, b1, b2, e1, e2, x,
+                                    splat<T, X>(*first));
+}
+
+/**
+ * @brief Evaluates a polynomial at `count` contiguous points, U*W points
+ * at a time, and writes the results, rounded to T, to `out`.
+ * @param evaluate - a functor computing the value at a pack of points
+ *
+ * The recurrences are sequential in the coefficients, so each of the U
+ * packs of W points evaluated together is an independent dependency chain.
+ * The last, incomplete block is padded with zeros.
+ */
+template<typename T, std::size_t W, std::size_t U, typename Evaluate, typename Out>
+inline Out evaluate_kernel(Evaluate evaluate, const T* x, std::size_t count, Out out)
+{
+    using P = pack<T, W>;
+    constexpr std::size_t block = U * W;
+    for (std::size_t i = 0; i < count; i += block)
+    {
+        const std::size_t points = std::min(block, count - i);
+        T arguments[block] = {};
+        std::copy(x + i, x + i + points, arguments);
+        P sums[U], comps[U];
+        evaluate(arguments, sums, comps);
+        for (std::size_t n = 0; n < points; n++)
+        {
+            *out = static_cast<T>(sums[n / W][n % W] + comps[n / W][n % W]);
+            ++out;
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Compensated Horner evaluation at `count` contiguous points,
+ * with the coefficients given by a bidirectional iterator range
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 4,
+         bool fused = hardware_fma, typename It, typename Out>
+inline Out horner_kernel(It first, It last, const T* x, std::size_t count, Out out)
+{
+    using P = pack<T, W>;
+    auto evaluate = [first, last](const T* arguments, P (&sums)[U], P (&comps)[U])
+    {
+        P points[U];
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {
+            load<T, W>(arguments + u*W, points[u]);
+            sums[u] = comps[u] = P{};
+        }
+        for (It coefficient = last; coefficient != first; )
+        {
+            const P c = broadcast<T, W>(*--coefficient);
+            COMPENSATED_UNROLL
+            for (std::size_t u = 0; u < U; u++)
+                horner_step<T, P, fused>(sums[u], comps[u], points[u], c);
+        }
+    };
+    return evaluate_kernel<T, W, U>(evaluate, x, count, out);
+}
+
+/**
+ * @brief Compensated Clenshaw evaluation at `count` contiguous points,
+ * with the coefficients given by a bidirectional iterator range
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 2,
+         bool fused = hardware_fma, typename It, typename Out>
+inline Out clenshaw_kernel(It first, It last, const T* x, std::size_t count, Out out)
+{
+    using P = pack<T, W>;
+    auto evaluate = [first, last](const T* arguments, P (&sums)[U], P (&comps)[U])
+    {
+        P points[U], two_x[U], b1[U] = {}, b2[U] = {}, e1[U] = {}, e2[U] = {};
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {
+            load<T, W>(arguments + u*W, points[u]);
+            two_x[u] = points[u] + points[u];
+            sums[u] = comps[u] = P{};
+        }
+        if (first == last)
+            return;
+        It coefficient = last;
+        while (--coefficient != first)
+        {
+            const P c = broadcast<T, W>(*coefficient);
+            COMPENSATED_UNROLL
+            for (std::size_t u = 0; u < U; u++)
+                clenshaw_step<T, P, fused>(b1[u], b2[u], e1[u], e2[u], two_x[u], c);
+        }
+        const P c = broadcast<T, W>(*first);
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+            clenshaw_last_step<T, P, fused>(sums[u], comps[u], b1[u], b2[u],
+                                            e1[u], e2[u], points[u], c);
+    };
+    return evaluate_kernel<T, W, U>(evaluate, x, count, out);
+}
+
+/**
+ * @brief Computes the sums of the first four powers of the deviations
+ * d = x - center of `count` contiguous values, and their extrema.
+ * @param sums - receives the sums of d, d^2, d^3, d^4
+ * @param lowest, highest - receive the smallest and the largest value
+ *
+ * The sums are meant for blocks short enough to stay in the cache, so
+ * that each lane sums few terms, without compensation.
+ */
+template<typename T, std::size_t W = native_lanes<T>, std::size_t U = 2>
+inline void deviation_power_sums(const T* data, std::size_t count, T center,
+                                 T (&sums)[4], T& lowest, T& highest)
+{
+    T s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+    T lo = std::numeric_limits<T>::infinity();
+    T hi = -std::numeric_limits<T>::infinity();
+    std::size_t i = 0;
+#if defined(__GNUC__)
+    using P = pack<T, W>;
+    const P c = broadcast<T, W>(center);
+    P p1[U] = {}, p2[U] = {}, p3[U] = {}, p4[U] = {};
+    P low[U], high[U];
+    for (std::size_t u = 0; u < U; u++)
+    {
+        low[u] = broadcast<T, W>(lo);
+        high[u] = broadcast<T, W>(hi);
+    }
+    for (; i + U*W <= count; i += U*W)
+    {
+        COMPENSATED_UNROLL
+        for (std::size_t u = 0; u < U; u++)
+        {
+            P x;
+            load<T, W>(data + i + u*W, x);
+            P d = x - c;
+            P d2 = d * d;
+            p1[u] += d;
+            p2[u] += d2;
+            p3[u] += d2 * d;
+            p4[u] += d2 * d2;
+            low[u] = (x < low[u]) ? x : low[u];
+            high[u] = (x > high[u]) ? x : high[u];
+        }
+    }
+    for (std::size_t u = 0; u < U; u++)
+        for (std::size_t k = 0; k < W; k++)
+        {
+            s1 += p1[u][k];
+            s2 += p2[u][k];
+            s3 += p3[u][k];
+            s4 += p4[u][k];
+            lo = std::min<T>(lo, low[u][k]);
+            hi = std::max<T>(hi, high[u][k]);
+        }
+#endif
+    for (; i < count; i++)
+    {
+        const T d = data[i] - center;
+        const T d2 = d * d;
+        s1 += d;
+        s2 += d2;
+        s3 += d2 * d;
+        s4 += d2 * d2;
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+    sums[0] = s1;
+    sums[1] = s2;
+    sums[2] = s3;
+    sums[3] = s4;
+    lowest = lo;
+    highest = hi;
+}
+
+/**
+ * @brief Adds (or subtracts) `count` contiguous values to as many
+ * independent compensated sums, stored as separate arrays of sums and
+ * compensations. Each lane performs a TwoSum, which yields the same
+ * result as a Kahan-Neumaier update.
+ */
+template<typename T, bool subtract, std::size_t W = native_lanes<T>>
+inline void elementwise_add(T* sums, T* comps, const T* x, std::size_t count)
+{
+    using P = pack<T, W>;
+    std::size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        P sum, comp, increment;
+        load<T, W>(sums + i, sum);
+        load<T, W>(comps + i, comp);
+        load<T, W>(x + i, increment);
+        if constexpr (subtract)
+            increment = P{} - increment;
+        lanes_two_sum(sum, comp, increment, P{});
+        store<T, W>(sums + i, sum);
+        store<T, W>(comps + i, comp);
+    }
+    for (; i < count; i++)
+        two_sum_step(sums[i], comps[i], subtract ? -x[i] : x[i]);
+}
+
+/**
+ * @brief Writes the rounded values of `count` compensated sums stored
+ * as separate arrays of sums and compensations
+ */
+template<typename T, std::size_t W = native_lanes<T>>
+inline void elementwise_round(const T* sums, const T* comps, T* out, std::size_t count)
+{
+    using P = pack<T, W>;
+    std::size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        P sum, comp;
+        load<T, W>(sums + i, sum);
+        load<T, W>(comps + i, comp);
+        store<T, W>(out + i, sum + comp);
+    }
+    for (; i < count; i++)
+        out[i] = sums[i] + comps[i];
+}
+
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+/*
+ * The variants of a kernel for the wider instruction sets. The kernel, given
+ * as a lambda, and the helpers it calls are marked COMPENSATED_KERNEL_INLINE,
+ * so that all of them are inlined into the variant and compiled for its
+ * instruction set; flattening also inlines the standard library functions
+ * they call, when optimizing.
+ */
+template<typename Kernel>
+[[gnu::target("avx2,fma"), gnu::flatten]]
+inline void run_avx2(const Kernel& kernel)
+{
+    kernel.template operator()<32, true>();
+}
+
+template<typename Kernel>
+[[gnu::target("avx512f,avx2,fma"), gnu::flatten]]
+inline void run_avx512(const Kernel& kernel)
+{
+    kernel.template operator()<64, true>();
+}
+#endif
+
+/**
+ * @brief Runs a vectorized kernel, given as a generic lambda whose template
+ * parameters are the width of the vector registers in bytes and whether
+ * FMA instructions are available, in its variant for the instruction set
+ * `isa`, which the processor must support (without runtime dispatch,
+ * always in the baseline variant)
+ */
+template<typename Kernel>
+inline void run_variant([[maybe_unused]] instruction_set isa, const Kernel& kernel)
+{
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+    switch (isa)
+    {
+    case instruction_set::avx512:
+        return run_avx512(kernel);
+    case instruction_set::avx2:
+        return run_avx2(kernel);
+    case instruction_set::baseline:
+        break;
+    }
+#endif
+    kernel.template operator()<COMPENSATED_VECTOR_BYTES, hardware_fma>();
+}
+
+/**
+ * @brief Runs a vectorized kernel (see run_variant()) for the instruction
+ * set selected by kernel_instruction_set()
+ */
+template<typename Kernel>
+inline void dispatch(const Kernel& kernel)
+{
+    run_variant(kernel_instruction_set(), kernel);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+} // namespace detail
+
+//=============================================================================================
+/**
+ * @mainclass
+ * class `value` - template class representing a value
+ * with compensated Kahan/Kahan-Neumaier addition.
+ * @param
+ * The first template parameter is the underlying "raw" value type.
+ * The second template parameter selects the summation algorithm.
+ */
+template<kahanizable V, algorithm A = default_algorithm<V>>
+requires supports_algorithm<V, A>
+class value
+{
+public:
+    /**
+     * @brief The summation algorithm used by this class
+     */
+    static constexpr algorithm method = A;
+
+    /**
+     * @brief The type of the running compensation. The second-order Klein
+     * algorithm keeps the compensation itself in a compensated value.
+     */
+    using compensation_type = std::conditional_t<A == algorithm::klein,
+                                                 value<V, algorithm::two_sum>,
+                                                 V>;
+private:
+    V Sum = 0;                                             // the sum
+    compensation_type Compensation = compensation_type(0); // the running compensation
+
+public:
+    // Constructors from nothing and from V:
+    constexpr value() = default;
+    explicit constexpr value(const V& initial_value)
+        : Sum{initial_value}
+    {
+        Compensation = 0;
+    }
+    /*
+     * Copy/move constructors and assignment operators: all defaulted.
+     * This class is default-constructible, trivially copiable and movable
+     */
+    ~value() = default;
+
+private:
+    // Constructor which manually sets the members. For internal use only.
+    explicit constexpr value(V S, compensation_type C) : Sum{S}, Compensation{C} {};
+
+public:
+//=== Conversion operators ===
+
+    /**
+     * @brief Conversion operator to the raw value type
+     */
+    inline constexpr operator V() const {return Sum + Compensation;}
+
+    /**
+     * @brief Assignment operator from raw value type
+     */
+    inline constexpr void operator= (V value)
+    {
+        Sum = value;
+        Compensation = 0;
+    }
+
+    /**
+     * @brief Provides an estimate of the error resulting from conversion
+     * to the raw value type
+     */
+    inline V error(void) const
+    {
+        V converted = V(*this);
+        return (Sum - converted) + Compensation;
+    }
+
+    /**
+     * @brief Extracts the real part of a complex value
+     */
+    inline constexpr auto real(void) const
+    requires is_complex<V>
+    {
+        return Sum.real() + Compensation.real();
+    }
+
+    /**
+     * @brief Extracts the imaginary part of a complex value
+     */
+    inline constexpr auto imag(void) const
+    requires is_complex<V>
+    {
+        return Sum.imag() + Compensation.imag();
+    }
+
+//=== Equality comparison operators ===
+// Note: the corresponding `!=` operators will be auto-generated
+// by the C++20 rewriting mechanism.
+
+    /**
+     * @brief operator== tries to determine if two objects represent the
+     * same mathematical value, even if represented differently
+     * @param other - right-hand side of comparison
+     * @return true on equality, false on inequality
+     */
+    inline constexpr bool operator== (const value& other) const
+    requires std::equality_comparable<V>
+    {
+        return (Sum - other.Sum == other.Compensation - Compensation);
+    }
+
+    /**
+     * @brief operator== tries to compare the value represented by this
+     * object with a raw value
+     * @param value - raw value to compare with
+     * @return true on equality, false on inequality
+     */
+    inline constexpr bool operator== (const V& value) const
+    requires std::equality_comparable<V>
+    {
+        return (Compensation == value - Sum) || (Sum == value - Compensation);
+    }
+
+//=== Unary minus ===
+    /**
+     * @brief Unary minus - for raw value types possessing a unary minus
+     */
+    inline constexpr value operator- (void) const
+    requires has_unary_minus<V>
+    {
+        return value(-Sum, -Compensation);
+    }
+
+    /**
+     * @brief Unary minus - for raw value types without a unary minus
+     */
+    inline constexpr value operator- (void) const
+    requires (! has_unary_minus<V>)
+    {
+        V zero = 0;
+        // We use subtraction from zero since there is no unary minus for V
+        return value(zero - Sum, zero - Compensation);
+    }
+
+// === Kahan-Neumaier summation operators (on the right) ===
+// --- Real case ---
+    /**
+     * @brief Add an element of type V using the Kahan-Neumaier addition
+     * (real case supported by std::abs, or a 16-bit floating-point type)
+     */
+    inline value operator+ (const V& increment) const
+    requires is_real<V> && (has_std_abs<V> || is_half_precision<V>)
+             && (A == algorithm::neumaier)
+    {
+        V naive_sum = Sum + increment;
+        if (detail::magnitude(Sum) > detail::magnitude(increment))
+        {
+            /* In this case, we have a large sum to which a small increment
+             * is added. Therefore, the compensation is computed by cancelling
+             * the large sum with the naive sum.
+             */
+            return value(naive_sum,
+                         Compensation + ((Sum - naive_sum) + increment));
+        }
+        else
+        {
+            /* In this case, the roles swap: the increment is larger than
+             * the old sum, so we use the increment for the cancellation.
+             */
+            return value(naive_sum,
+                         Compensation + ((increment - naive_sum) + Sum));
+        }
+    }
+
+    /**
+     * @brief Add an element of type V using the Kahan-Neumaier addition
+     * (real case with user-supplied abs() member)
+     */
+    inline value operator+ (const V& increment) const
+    requires is_real<V> && has_custom_abs<V> && (!has_std_abs<V>)
+             && (A == algorithm::neumaier)
+    { // See comments for the version with std::abs for explanation
+        V naive_sum = Sum + increment;
+        if (Sum.abs() > increment.abs())
+            return value(naive_sum,
+                         Compensation + ((Sum - naive_sum) + increment));
+        else
+            return value(naive_sum,
+                         Compensation + ((increment - naive_sum) + Sum));
+    }
+
+    /**
+     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
+     * (real case supported by std::abs, or a 16-bit floating-point type)
+     */
+    inline void operator+= (const V& increment)
+    requires is_real<V> && (has_std_abs<V> || is_half_precision<V>)
+             && (A == algorithm::neumaier)
+    {
+        V naive_sum = Sum + increment;
+        if (detail::magnitude(Sum) > detail::magnitude(increment)) // See comments in operator+
+            Compensation = Compensation + ((Sum - naive_sum) + increment);
+        else
+            Compensation = Compensation + ((increment - naive_sum) + Sum);
+        Sum = naive_sum;
+    }
+
+    /**
+     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
+     * (real case with user-supplied abs() member)
+     */
+    inline void operator+= (const V& increment)
+    requires is_real<V> && has_custom_abs<V> && (!has_std_abs<V>)
+             && (A == algorithm::neumaier)
+    {
+        V naive_sum = Sum + increment;
+        if (Sum.abs() > increment.abs()) // See comments in operator+
+            Compensation = Compensation + ((Sum - naive_sum) + increment);
+        else
+            Compensation = Compensation + ((increment - naive_sum) + Sum);
+        Sum = naive_sum;
+    }
+
+// --- Complex case
+    /**
+     * @brief Add an element of type V using the Kahan-Neumaier addition
+     * (complex case)
+     */
+    inline value operator+ (const V& increment) const
+    requires is_complex<V> && (A == algorithm::neumaier)
+    {
+        V naive_sum = Sum + increment;
+        auto inc_real = increment.real();
+        auto inc_imag = increment.imag();
+
+        // Real and imaginary parts of the update to Compensation:
+        decltype(inc_real) comp_update_real, comp_update_imag;
+
+        // Compute the update to the real part of the compensation
+        if (std::abs(Sum.real()) > std::abs(inc_real))
+            comp_update_real = (Sum.real() - naive_sum.real()) + inc_real;
+        else
+            comp_update_real = (inc_real - naive_sum.real()) + Sum.real();
+
+        // Compute the update to the imaginary part of the compensation
+        if (std::abs(Sum.imag()) > std::abs(inc_imag))
+            comp_update_imag = (Sum.imag() - naive_sum.imag()) + inc_imag;
+        else
+            comp_update_imag = (inc_imag - naive_sum.imag()) + Sum.imag();
+
+        return value(naive_sum,
+                     Compensation + V(comp_update_real, comp_update_imag));
+    }
+
+    /**
+     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
+     * (complex case)
+     */
+    inline void operator+= (const V& increment)
+    requires is_complex<V> && (A == algorithm::neumaier)
+    {
+        V naive_sum = Sum + increment;
+        auto inc_real = increment.real();
+        auto inc_imag = increment.imag();
+
+        // Real and imaginary parts of the update to Compensation:
+        decltype(inc_real) comp_update_real, comp_update_imag;
+
+        // Compute the update to the real part of the compensation
+        if (std::abs(Sum.real()) > std::abs(inc_real))
+            comp_update_real = (Sum.real() - naive_sum.real()) + inc_real;
+        else
+            comp_update_real = (inc_real - naive_sum.real()) + Sum.real();
+
+        // Compute the update to the imaginary part of the compensation
+        if (std::abs(Sum.imag()) > std::abs(inc_imag))
+            comp_update_imag = (Sum.imag() - naive_sum.imag()) + inc_imag;
+        else
+            comp_update_imag = (inc_imag - naive_sum.imag()) + Sum.imag();
+
+        // Update in-place:
+        Sum = naive_sum;
+        Compensation = Compensation + V(comp_update_real, comp_update_imag);
+    }
+
+// --- Plain Kahan algorithm (default when V is neither real nor complex)
+    /**
+     * @brief Add an element of type V using plain Kahan summation
+     */
+    inline value operator+ (const V& increment) const
+    requires (A == algorithm::kahan)
+    {   // plain Kahan
+        V naive_sum = Sum + increment;
+        return value(naive_sum,
+                     Compensation + ((Sum - naive_sum) + increment));
+    }
+
+    /**
+     * @brief Add in-place an element of type V using plain Kahan summation
+     */
+    inline void operator+= (const V& increment)
+    requires (A == algorithm::kahan)
+    {   // plain Kahan
+        V naive_sum = Sum + increment;
+        Compensation = Compensation + ((Sum - naive_sum) + increment);
+        Sum = naive_sum;
+    }
+
+// --- Branch-free TwoSum algorithm
+    /**
+     * @brief Add an element of type V using Knuth's TwoSum; the result is
+     * the same as with Kahan-Neumaier, but no magnitudes are compared
+     */
+    inline value operator+ (const V& increment) const
+    requires (A == algorithm::two_sum)
+    {
+        auto [naive_sum, error] = two_sum(Sum, increment);
+        return value(naive_sum, Compensation + error);
+    }
+
+    /**
+     * @brief Add in-place an element of type V using Knuth's TwoSum
+     */
+    inline void operator+= (const V& increment)
+    requires (A == algorithm::two_sum)
+    {
+        auto [naive_sum, error] = two_sum(Sum, increment);
+        Compensation = Compensation + error;
+        Sum = naive_sum;
+    }
+
+// --- Klein's second-order algorithm
+    /**
+     * @brief Add an element of type V using Klein's second-order algorithm:
+     * the rounding error of each addition is itself added with compensation
+     */
+    inline value operator+ (const V& increment) const
+    requires (A == algorithm::klein)
+    {
+        auto [naive_sum, error] = two_sum(Sum, increment);
+        return value(naive_sum, Compensation + error);
+    }
+
+    /**
+     * @brief Add in-place an element of type V using Klein's second-order
+     * algorithm
+     */
+    inline void operator+= (const V& increment)
+    requires (A == algorithm::klein)
+    {
+        auto [naive_sum, error] = two_sum(Sum, increment);
+        Compensation += error;
+        Sum = naive_sum;
+    }
+
+// --- Naive summation, for reference
+    /**
+     * @brief Add an element of type V without any compensation
+     */
+    inline value operator+ (const V& increment) const
+    requires (A == algorithm::naive)
+    {
+        return value(Sum + increment, Compensation);
+    }
+
+    /**
+     * @brief Add in-place an element of type V without any compensation
+     */
+    inline void operator+= (const V& increment)
+    requires (A == algorithm::naive)
+    {
+        Sum = Sum + increment;
+    }
+
+// === Operators that are common to all cases
+    /**
+     * @brief Adds an element of the same type
+     */
+    inline value operator+ (const value& other) const
+    {   // re-use previously defined operators:
+        return operator+(other.Sum) + other.Compensation;
+    }
+
+    /**
+     * @brief Adds in-place an element of the same type
+     */
+    inline void operator+= (const value& other)
+    {   // re-use previosly defined operators:
+        operator+=(other.Sum);
+        operator+=(other.Compensation);
+    }
+
+    /**
+     * @brief Adds in-place a compensated value of another type, e.g.,
+     * a value<float> to a value<double>, or the other way round. When U is
+     * wider than V, the error of rounding the value to V goes to the
+     * compensation, with the error of the other object.
+     */
+    template<typename U, algorithm B>
+    requires (!std::same_as<U, V>) && std::convertible_to<U, V>
+    inline void operator+= (const value<U, B>& other)
+    {
+        const U rounded = static_cast<U>(other);
+        const V high = static_cast<V>(rounded);
+        operator+=(high);
+        operator+=(static_cast<V>((rounded - static_cast<U>(high)) + other.error()));
+    }
+
+    /**
+     * @brief Adds an entire collection of raw value types to the
+     * present object. The collection is described by a pair of iterators
+     * of templated iterator type `It`. We require the iterator type `It`
+     * to behave like an iterator to V, i.e., to satisfy the concept
+     * is_iterator_to<It, V>. The Kahan-Neumaier, TwoSum and Klein sums spread
+     * the elements over several independent accumulators; the naive and plain
+     * Kahan sums add them strictly in order.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        accumulate_until(first, last);
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of floats or doubles to the
+     * present object, using a vectorized kernel which runs several
+     * Kahan-Neumaier accumulators in parallel and merges them at the end.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && is_contiguous_iterator_to<It, V>
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate(It first, It last)
+    {
+        if (first == last)
+            return;
+        V partial_sum, partial_compensation;
+        detail::dispatch([&]<std::size_t bytes, bool>() COMPENSATED_KERNEL_INLINE
+        {
+            detail::sum_kernel<V, detail::lanes_in<V, bytes>>(
+                std::to_address(first), static_cast<std::size_t>(last - first),
+                partial_sum, partial_compensation);
+        });
+        operator+=(value(partial_sum, partial_compensation));
+    }
+
+    /**
+     * @brief Adds the products of corresponding elements of two collections
+     * (i.e., their dot product) to the present object. For floating-point
+     * types, including complex ones, the rounding error of each product is
+     * computed with the TwoProd transformation and added to the compensation,
+     * as in Ogita, Rump and Oishi's Dot2 algorithm. The result is then as
+     * accurate as if computed in twice the working precision.
+     * @param first_x - the iterator to the beginning of the first collection
+     * @param last_x  - the iterator to "one-past" last element of the first collection
+     * @param first_y - the iterator to the beginning of the second collection,
+     *                  which must be at least as long as the first one
+     */
+    template<typename ItX, typename ItY>
+    requires ring_element<V> && is_iterator_to<ItX, V> && is_iterator_to<ItY, V>
+    inline void accumulate_products(ItX first_x, ItX last_x, ItY first_y)
+    {
+        auto y = first_y;
+        for (auto x = first_x; x != last_x; ++x, ++y)
+            add_product(*x, *y);
+    }
+
+    /**
+     * @brief Adds the dot product of two contiguous ranges of floats or doubles
+     * to the present object, using a vectorized Dot2 kernel
+     */
+    template<typename ItX, typename ItY>
+    requires ring_element<V> && is_iterator_to<ItX, V> && is_iterator_to<ItY, V>
+             && is_contiguous_iterator_to<ItX, V>
+             && is_contiguous_iterator_to<ItY, V>
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate_products(ItX first_x, ItX last_x, ItY first_y)
+    {
+        if (first_x == last_x)
+            return;
+        V partial_sum, partial_compensation;
+        detail::dispatch([&]<std::size_t bytes, bool fused>() COMPENSATED_KERNEL_INLINE
+        {
+            detail::dot_kernel<V, detail::lanes_in<V, bytes>, 4, fused>(
+                std::to_address(first_x), std::to_address(first_y),
+                static_cast<std::size_t>(last_x - first_x),
+                partial_sum, partial_compensation);
+        });
+        operator+=(value(partial_sum, partial_compensation));
+    }
+
+    /**
+     * @brief Adds the dot product (without conjugation) of two contiguous
+     * ranges of std::complex numbers to the present object, using a
+     * vectorized Dot2 kernel
+     */
+    template<typename ItX, typename ItY>
+    requires ring_element<V> && is_iterator_to<ItX, V> && is_iterator_to<ItY, V>
+             && is_contiguous_complex_iterator_to<ItX, V>
+             && is_contiguous_complex_iterator_to<ItY, V>
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate_products(ItX first_x, ItX last_x, ItY first_y)
+    {
+        if (first_x == last_x)
+            return;
+        V partial_sum, partial_compensation;
+        detail::dispatch([&]<std::size_t bytes, bool fused>() COMPENSATED_KERNEL_INLINE
+        {
+            using T = typename V::value_type;
+            detail::complex_dot_kernel<T, std::max<std::size_t>(2, detail::lanes_in<T, bytes>),
+                                       2, fused>(
+                std::to_address(first_x), std::to_address(first_y),
+                static_cast<std::size_t>(last_x - first_x),
+                partial_sum, partial_compensation);
+        });
+        operator+=(value(partial_sum, partial_compensation));
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of raw values of another
+     * arithmetic type (e.g., integers or floats to a sum of doubles) to the
+     * present object, using the vectorized kernel, which converts the values
+     * to V as it loads them.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && is_contiguous_convertible_iterator_to<It, V>
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate(It first, It last)
+    {
+        if (first == last)
+            return;
+        V partial_sum, partial_compensation;
+        detail::dispatch([&]<std::size_t bytes, bool>() COMPENSATED_KERNEL_INLINE
+        {
+            detail::converting_sum_kernel<V, std::iter_value_t<It>, true,
+                                          detail::lanes_in<V, bytes>>(
+                std::to_address(first), static_cast<std::size_t>(last - first),
+                partial_sum, partial_compensation);
+        });
+        operator+=(value(partial_sum, partial_compensation));
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of std::complex numbers with
+     * float or double parts to the present object, using a vectorized kernel
+     * which runs Kahan-Neumaier accumulators on the interleaved real and
+     * imaginary parts and merges them at the end.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && is_contiguous_complex_iterator_to<It, V>
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate(It first, It last)
+    {
+        if (first == last)
+            return;
+        V partial_sum, partial_compensation;
+        detail::dispatch([&]<std::size_t bytes, bool>() COMPENSATED_KERNEL_INLINE
+        {
+            using T = typename V::value_type;
+            detail::complex_sum_kernel<T, std::max<std::size_t>(2, detail::lanes_in<T, bytes>)>(
+                std::to_address(first), static_cast<std::size_t>(last - first),
+                partial_sum, partial_compensation);
+        });
+        operator+=(value(partial_sum, partial_compensation));
+    }
+
+    /**
+     * @brief Adds all the elements of a range, such as a container or a view
+     * (e.g., std::views::transform or std::views::filter). Contiguous ranges
+     * of arithmetic types are summed through pointers, so that the vectorized
+     * kernels are used for floats and doubles, and an unrolled loop for other
+     * types. Other sized random-access ranges of arithmetic values summed as
+     * floats or doubles, such as std::views::transform of a vector, are
+     * copied in chunks to a buffer on the stack and summed by the vectorized
+     * kernel chunk by chunk. The remaining ranges (e.g., std::views::filter,
+     * which is neither sized nor random-access, or ranges of compensated
+     * values, whose errors must not be dropped) are summed element by element
+     * up to their end or sentinel; use accumulate_buffered() to buffer
+     * filtered raw values as well.
+     * @param range - the range of values to be added
+     */
+    template<typename R>
+    requires is_range_of<R, V>
+    inline void accumulate(R&& range)
+    {
+        using element = std::ranges::range_value_t<R>;
+        constexpr bool raw = std::is_arithmetic_v<element> || is_half_precision<element>;
+        if constexpr (std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && raw)
+        {
+            const element* data = std::ranges::data(range);
+            accumulate(data, data + std::ranges::size(range));
+        }
+        else if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+                           && raw && is_vector_summable<V>
+                           && (A == algorithm::neumaier || A == algorithm::two_sum))
+            accumulate_chunks(std::ranges::begin(range), std::ranges::size(range));
+        else if constexpr (std::ranges::common_range<R>)
+            accumulate(std::ranges::begin(range), std::ranges::end(range));
+        else
+            accumulate_until(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    /**
+     * @brief Adds all the elements of any input range, copying them in
+     * chunks to a buffer on the stack which is summed by the vectorized
+     * kernel. This is worthwhile for views whose elements are cheap to
+     * produce but which accumulate() sums element by element, such as
+     * `v | std::views::filter(p)` or std::views::transform of a list.
+     * Sized random-access ranges are buffered as by accumulate(). The
+     * elements must be raw arithmetic values, which the buffer holds exactly.
+     * @param range - the range of values to be added
+     */
+    template<typename R>
+    requires is_range_of<R, V> && is_vector_summable<V>
+             && (std::is_arithmetic_v<std::ranges::range_value_t<R>>
+                 || is_half_precision<std::ranges::range_value_t<R>>)
+             && (A == algorithm::neumaier || A == algorithm::two_sum)
+    inline void accumulate_buffered(R&& range)
+    {
+        if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>)
+            accumulate_chunks(std::ranges::begin(range), std::ranges::size(range));
+        else
+            accumulate_chunks_until(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+    /**
+     * @brief Adds an entire collection of raw value types to the present
+     * object, under a standard execution policy (such as
+     * std::execution::par_unseq). The range is split into chunks of fixed
+     * size, each chunk is summed into its own object of the present class,
+     * and the partial results are added to the present object in order.
+     * Since the chunks do not depend on the number of threads, the result
+     * is the same as with std::execution::seq. If the standard library has
+     * no parallel backend, the chunks are summed sequentially.
+     * @param policy - the execution policy
+     * @param first - the random-access iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename ExecutionPolicy, typename It>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+             && is_iterator_to<It, V> && std::random_access_iterator<It>
+    inline void accumulate(ExecutionPolicy&& policy, It first, It last)
+    {
+        detail::parallel_accumulate(*this, std::forward<ExecutionPolicy>(policy),
+                                    first, last);
+    }
+
+    /**
+     * @brief Adds an entire collection of raw value types to the present
+     * object, under a standard execution policy. Ranges without
+     * random access cannot be split cheaply, so they are summed sequentially.
+     */
+    template<typename ExecutionPolicy, typename It>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+             && is_iterator_to<It, V> && (!std::random_access_iterator<It>)
+    inline void accumulate(ExecutionPolicy&&, It first, It last)
+    {
+        accumulate(first, last);
+    }
+#endif
+// --- Variants of operator `-`
+    /**
+     * @brief Subtracts a raw value from the value object
+     */
+    inline value operator- (const V& increment) const
+    requires has_unary_minus<V>
+    {
+        return operator+(-increment);
+    }
+
+    /**
+     * @brief Subtracts a raw value from the value object
+     */
+    inline value operator- (const V& increment) const
+    requires (!has_unary_minus<V>)
+    {
+        V zero = 0;
+        return operator+(zero-increment);
+    }
+
+    /**
+     * @brief Subtracts in-place a raw value from the value object
+     */
+    inline void operator-= (const V& increment)
+    requires has_unary_minus<V>
+    {
+        operator+=(-increment);
+    }
+
+    /**
+     * @brief Subtracts in-place a raw value from the value object
+     */
+    inline void operator-= (const V& increment)
+    requires (!has_unary_minus<V>)
+    {
+        V zero = 0;
+        operator+=(zero-increment);
+    }
+
+    /**
+     * @brief Subtracts another value object from the current one
+     */
+    inline value operator- (const value& other) const
+    {
+        return operator+(-other);
+    }
+
+    /**
+     * @brief Subtracts in-place another value object from the current one
+     */
+    inline void operator-= (const value& other)
+    {
+        operator+=(-other);
+    }
+
+private:
+    /**
+     * @brief Adds the elements from `first` up to the iterator or sentinel
+     * `last`, in the generic case. The naive and plain Kahan sums add them
+     * strictly from left to right, so that they remain the sequential
+     * reference results.
+     */
+    template<typename It, typename S>
+    inline void accumulate_until(It first, S last)
+    {
+        if constexpr (A == algorithm::naive || A == algorithm::kahan)
+        {
+            for (auto iter = first; iter != last; ++iter)
+                operator+=(*iter);
+            return;
+        }
+        /* A single accumulator makes every addition wait for the previous
+         * one to update Sum and Compensation. Instead, we spread the elements
+         * over several independent accumulators, whose additions can overlap
+         * in the pipeline, and merge them with compensation at the end.
+         */
+        value partial[4];
+        auto iter = first;
+        while (iter != last)
+        {
+            partial[0] += *iter;
+            if (!(++iter != last))
+                break;
+            partial[1] += *iter;
+            if (!(++iter != last))
+                break;
+            partial[2] += *iter;
+            if (!(++iter != last))
+                break;
+            partial[3] += *iter;
+            ++iter;
+        }
+        for (const auto& p : partial)
+            operator+=(p);
+    }
+
+    /**
+     * @brief Adds `count` elements starting at the random-access iterator
+     * `first`, copying them in chunks to a buffer which is summed by the
+     * vectorized kernel. The lanes of the kernel are merged only once, at
+     * the end; only the last chunk may leave a tail shorter than a block.
+     */
+    template<typename It>
+    inline void accumulate_chunks(It first, std::size_t count)
+    {
+        detail::lane_sums<V> lanes;
+        static_assert(detail::buffer_chunk_size % lanes.block == 0);
+        V buffer[detail::buffer_chunk_size];
+        V tail_sum = 0;
+        V tail_compensation = 0;
+        for (std::size_t start = 0; start < count; start += detail::buffer_chunk_size)
+        {
+            const std::size_t chunk = std::min(detail::buffer_chunk_size, count - start);
+            for (std::size_t i = 0; i < chunk; i++)
+                buffer[i] = static_cast<V>(first[static_cast<std::iter_difference_t<It>>(start + i)]);
+            for (std::size_t i = lanes.add_blocks(buffer, chunk); i < chunk; i++)
+                detail::two_sum_step(tail_sum, tail_compensation, buffer[i]);
+        }
+        lanes.merge(tail_sum, tail_compensation);
+        operator+=(value(tail_sum, tail_compensation));
+    }
+
+    /**
+     * @brief Adds the elements from `first` up to the iterator or sentinel
+     * `last`, whose distance is not known in advance, copying them in chunks
+     * to a buffer which is summed by the vectorized kernel
+     */
+    template<typename It, typename S>
+    inline void accumulate_chunks_until(It first, S last)
+    {
+        detail::lane_sums<V> lanes;
+        static_assert(detail::buffer_chunk_size % lanes.block == 0);
+        V buffer[detail::buffer_chunk_size];
+        V tail_sum = 0;
+        V tail_compensation = 0;
+        while (first != last)
+        {
+            std::size_t chunk = 0;
+            for (; chunk < detail::buffer_chunk_size && first != last; ++first)
+                buffer[chunk++] = static_cast<V>(*first);
+            for (std::size_t i = lanes.add_blocks(buffer, chunk); i < chunk; i++)
+                detail::two_sum_step(tail_sum, tail_compensation, buffer[i]);
+        }
+        lanes.merge(tail_sum, tail_compensation);
+        operator+=(value(tail_sum, tail_compensation));
+    }
+
+    /**
+     * @brief Adds the product of two real floating-point values, with
+     * its rounding error going to the compensation
+     */
+    inline void add_product(const V& a, const V& b)
+    requires std::floating_point<V>
+    {
+        V product = a * b;
+        operator+=(product);
+        if constexpr (A != algorithm::naive)
+            Compensation += detail::product_error(a, b, product);
+    }
+
+    /**
+     * @brief Adds the product of two complex values with floating-point
+     * parts, with the rounding errors going to the compensation
+     */
+    inline void add_product(const V& a, const V& b)
+    requires is_floating_complex<V>
+    {
+        using T = decltype(a.real());
+        const T direct_re = a.real() * b.real(), direct_im = a.imag() * b.imag();
+        const T cross_re = a.real() * b.imag(), cross_im = a.imag() * b.real();
+        operator+=(V(direct_re, cross_re));
+        operator+=(V(-direct_im, cross_im));
+        if constexpr (A != algorithm::naive)
+            Compensation += V(detail::product_error(a.real(), b.real(), direct_re)
+                            - detail::product_error(a.imag(), b.imag(), direct_im),
+                              detail::product_error(a.real(), b.imag(), cross_re)
+                            + detail::product_error(a.imag(), b.real(), cross_im));
+    }
+
+    /**
+     * @brief Adds the product of two values of other types
+     */
+    inline void add_product(const V& a, const V& b)
+    requires (!std::floating_point<V>) && (!is_floating_complex<V>)
+    {
+        operator+=(V(a * b));
+    }
+}; // class value
+
+// ==== Left operators: V + value<V>, V - value<V>
+/**
+ * @brief The concept of a raw value which may appear on the left of an operator
+ * with value<V>: either V itself, or an arithmetic type convertible to V
+ * (e.g., 1 + value<double>). Matching it exactly keeps the built-in operators,
+ * reachable through the conversion of value<V> to V, out of the competition.
+ */
+template<typename U, typename V>
+concept left_operand_for = std::same_as<U, V>
+                         || (std::is_arithmetic_v<U> && std::convertible_to<U, V>);
+
+/**
+ * @brief Operator `+` for adding a raw value on the left
+ */
+template<typename U, kahanizable V, algorithm A>
+requires left_operand_for<U, V>
+inline value<V, A> operator+(U raw, value<V, A> kn)
+{
+    return kn + V(raw);
+}
+
+/**
+ * @brief Operator `-` for subtracting from a raw value
+ */
+template<typename U, kahanizable V, algorithm A>
+requires left_operand_for<U, V>
+inline value<V, A> operator-(U raw, value<V, A> kn)
+{
+    return (-kn) + V(raw);
+}
+// ==== Left equality comparison operator: V == value<V>
+/**
+ * @brief Operator `==` with raw value on the left
+ */
+template<typename U, kahanizable V, algorithm A>
+requires left_operand_for<U, V> && std::equality_comparable<V>
+inline bool operator==(U raw, value<V, A> kn)
+{
+    return (kn == V(raw));
+}
+// Note: operator!= will be auto-generated through C++20 "rewriting"
+
+// ==== Dot products
+/**
+ * @brief Compensated dot product (Ogita, Rump and Oishi's Dot2) of two
+ * collections, in the style of std::inner_product
+ * @param first_x - the iterator to the beginning of the first collection
+ * @param last_x  - the iterator to "one-past" last element of the first collection
+ * @param first_y - the iterator to the beginning of the second collection,
+ *                  which must be at least as long as the first one
+ * @return the dot product as a compensated value
+ */
+template<typename ItX, typename ItY, typename V = std::iter_value_t<ItX>>
+requires kahanizable<V> && ring_element<V>
+         && is_iterator_to<ItX, V> && is_iterator_to<ItY, V>
+inline value<V> dot(ItX first_x, ItX last_x, ItY first_y)
+{
+    value<V> result;
+    result.accumulate_products(first_x, last_x, first_y);
+    return result;
+}
+
+/**
+ * @brief Compensated dot product of two containers, the second of which
+ * must be at least as long as the first one
+ * @return the dot product as a compensated value
+ */
+template<typename X, typename Y>
+requires requires(const X& x, const Y& y)
+{
+    dot(std::begin(x), std::end(x), std::begin(y));
+}
+inline auto dot(const X& x, const Y& y)
+{
+    return dot(std::begin(x), std::end(x), std::begin(y));
+}
+
+//=============================================================================================
+/*
+ * Compensated evaluation of polynomials.
+ *
+ * The compensated Horner scheme (Graillat, Langlois and Louvet) and the
+ * compensated Clenshaw recurrence (Jiang, Li and Cheng) carry the rounding
+ * errors of every step, obtained with TwoProd and TwoSum, through a second
+ * recurrence. The result is as accurate as if computed in twice the working
+ * precision and then rounded, so that polynomials can be evaluated close
+ * to their roots. The batched overloads evaluate one polynomial at many
+ * points, several points per vector register.
+ */
+
+/**
+ * @brief Compensated Horner evaluation of the polynomial
+ * a_0 + a_1 x + ... + a_n x^n
+ * @param first - the iterator to the coefficient a_0
+ * @param last  - the iterator to "one-past" the coefficient a_n
+ * @param x     - the point at which the polynomial is evaluated, converted
+ *                to the type of the coefficients
+ * @return the value of the polynomial as a compensated value
+ */
+template<typename It, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+inline value<V> horner(It first, It last, std::type_identity_t<V> x)
+{
+    V sum, compensation;
+    detail::horner_evaluate<V>(first, last, x, sum, compensation);
+    value<V> result{sum};
+    result += compensation;
+    return result;
+}
+
+/**
+ * @brief Compensated Clenshaw evaluation of the Chebyshev series
+ * c_0 T_0(x) + c_1 T_1(x) + ... + c_n T_n(x)
+ * @param first - the iterator to the coefficient c_0
+ * @param last  - the iterator to "one-past" the coefficient c_n
+ * @param x     - the point at which the series is evaluated, usually in [-1, 1],
+ *                converted to the type of the coefficients
+ * @return the value of the series as a compensated value
+ */
+template<typename It, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+inline value<V> clenshaw(It first, It last, std::type_identity_t<V> x)
+{
+    V sum, compensation;
+    detail::clenshaw_evaluate<V>(first, last, x, sum, compensation);
+    value<V> result{sum};
+    result += compensation;
+    return result;
+}
+
+/**
+ * @brief Batched compensated Horner evaluation: evaluates the polynomial
+ * with coefficients [first, last) (in ascending order of powers) at each
+ * of the points [first_x, last_x), in the style of std::transform
+ * @param out - the iterator to which the values, rounded to the raw
+ *              value type, are written
+ * @return the iterator past the last value written
+ */
+template<typename It, typename ItX, typename Out, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+         && is_iterator_to<ItX, V> && std::output_iterator<Out, V>
+inline Out horner(It first, It last, ItX first_x, ItX last_x, Out out)
+{
+    for (auto x = first_x; x != last_x; ++x, ++out)
+        *out = V(horner(first, last, V(*x)));
+    return out;
+}
+
+/**
+ * @brief Batched compensated Horner evaluation at contiguous floats
+ * or doubles, using a vectorized kernel which evaluates several points
+ * in each vector register
+ */
+template<typename It, typename ItX, typename Out, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+         && is_iterator_to<ItX, V> && std::output_iterator<Out, V>
+         && is_contiguous_iterator_to<ItX, V>
+inline Out horner(It first, It last, ItX first_x, ItX last_x, Out out)
+{
+    return detail::horner_kernel(first, last, std::to_address(first_x),
+                                 static_cast<std::size_t>(last_x - first_x), out);
+}
+
+/**
+ * @brief Batched compensated Clenshaw evaluation: evaluates the Chebyshev
+ * series with coefficients [first, last) at each of the points
+ * [first_x, last_x), in the style of std::transform
+ * @param out - the iterator to which the values, rounded to the raw
+ *              value type, are written
+ * @return the iterator past the last value written
+ */
+template<typename It, typename ItX, typename Out, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+         && is_iterator_to<ItX, V> && std::output_iterator<Out, V>
+inline Out clenshaw(It first, It last, ItX first_x, ItX last_x, Out out)
+{
+    for (auto x = first_x; x != last_x; ++x, ++out)
+        *out = V(clenshaw(first, last, V(*x)));
+    return out;
+}
+
+/**
+ * @brief Batched compensated Clenshaw evaluation at contiguous floats
+ * or doubles, using a vectorized kernel which evaluates several points
+ * in each vector register
+ */
+template<typename It, typename ItX, typename Out, typename V = std::iter_value_t<It>>
+requires std::floating_point<V> && std::bidirectional_iterator<It>
+         && is_iterator_to<ItX, V> && std::output_iterator<Out, V>
+         && is_contiguous_iterator_to<ItX, V>
+inline Out clenshaw(It first, It last, ItX first_x, ItX last_x, Out out)
+{
+    return detail::clenshaw_kernel(first, last, std::to_address(first_x),
+                                   static_cast<std::size_t>(last_x - first_x), out);
+}
+
+//=============================================================================================
+/*
+ * Compensated prefix sums.
+ *
+ * The scans carry the full state of a compensated value from one element to
+ * the next. The output iterator may accept either the compensated values
+ * themselves or the raw value type, in which case each output is rounded.
+ * Like their counterparts in the standard library, the scans may be
+ * performed in place.
+ */
+
+/**
+ * @brief Compensated inclusive scan: the i-th output is the sum of the
+ * elements up to and including the i-th one
+ * @param first - the iterator to the beginning of the collection
+ * @param last  - the iterator to "one-past" last element of collection
+ * @param out   - the output iterator, accepting value<V> or V
+ * @return the iterator past the last output
+ */
+template<typename It, typename Out, typename V = std::iter_value_t<It>>
+requires kahanizable<V> && is_iterator_to<It, V> && std::output_iterator<Out, value<V>>
+inline Out inclusive_scan(It first, It last, Out out)
+{
+    value<V> running;
+    for (; first != last; ++first, ++out)
+    {
+        running += *first;
+        *out = running;
+    }
+    return out;
+}
+
+/**
+ * @brief Compensated exclusive scan: the i-th output is the sum of `init`
+ * and the elements preceding the i-th one
+ * @param first - the iterator to the beginning of the collection
+ * @param last  - the iterator to "one-past" last element of collection
+ * @param out   - the output iterator, accepting value<V> or V
+ * @param init  - the initial value
+ * @return the iterator past the last output
+ */
+template<typename It, typename Out, typename V = std::iter_value_t<It>>
+requires kahanizable<V> && is_iterator_to<It, V> && std::output_iterator<Out, value<V>>
+inline Out exclusive_scan(It first, It last, Out out, std::type_identity_t<V> init)
+{
+    value<V> running{init};
+    for (; first != last; ++first, ++out)
+    {
+        const V x = *first; // read first, for in-place scans
+        *out = running;
+        running += x;
+    }
+    return out;
+}
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @brief Compensated inclusive scan under a standard execution policy.
+ * The range is split into chunks of fixed size. The first pass sums each
+ * chunk (with the vectorized kernels, where available); the second scans
+ * each chunk starting from the sum of the preceding chunks. The results do
+ * not depend on the number of threads, but they may differ from those of
+ * the sequential scan in the last bits.
+ * @param policy - the execution policy
+ * @param first - the random-access iterator to the beginning of the collection
+ * @param last  - the iterator to "one-past" last element of collection
+ * @param out   - the random-access output iterator, accepting value<V> or V
+ * @return the iterator past the last output
+ */
+template<typename ExecutionPolicy, typename It, typename Out, typename V = std::iter_value_t<It>>
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+         && kahanizable<V> && is_iterator_to<It, V> && std::random_access_iterator<It>
+         && std::output_iterator<Out, value<V>> && std::random_access_iterator<Out>
+inline Out inclusive_scan(ExecutionPolicy&& policy, It first, It last, Out out)
+{
+    return detail::parallel_scan(policy, first, last, out, value<V>{}, true);
+}
+
+/**
+ * @brief Compensated exclusive scan under a standard execution policy,
+ * performed in two passes like the parallel inclusive_scan()
+ * @param policy - the execution policy
+ * @param first - the random-access iterator to the beginning of the collection
+ * @param last  - the iterator to "one-past" last element of collection
+ * @param out   - the random-access output iterator, accepting value<V> or V
+ * @param init  - the initial value
+ * @return the iterator past the last output
+ */
+template<typename ExecutionPolicy, typename It, typename Out, typename V = std::iter_value_t<It>>
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+         && kahanizable<V> && is_iterator_to<It, V> && std::random_access_iterator<It>
+         && std::output_iterator<Out, value<V>> && std::random_access_iterator<Out>
+inline Out exclusive_scan(ExecutionPolicy&& policy, It first, It last, Out out,
+                          std::type_identity_t<V> init)
+{
+    return detail::parallel_scan(policy, first, last, out, value<V>{init}, false);
+}
+
+/**
+ * @brief Compensated inclusive scan under a standard execution policy,
+ * for iterators without random access: the scan is sequential.
+ */
+template<typename ExecutionPolicy, typename It, typename Out, typename V = std::iter_value_t<It>>
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+         && kahanizable<V> && is_iterator_to<It, V> && std::output_iterator<Out, value<V>>
+         && (!std::random_access_iterator<It> || !std::random_access_iterator<Out>)
+inline Out inclusive_scan(ExecutionPolicy&&, It first, It last, Out out)
+{
+    return compensated::inclusive_scan(first, last, out);
+}
+
+/**
+ * @brief Compensated exclusive scan under a standard execution policy,
+ * for iterators without random access: the scan is sequential.
+ */
+template<typename ExecutionPolicy, typename It, typename Out, typename V = std::iter_value_t<It>>
+requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+         && kahanizable<V> && is_iterator_to<It, V> && std::output_iterator<Out, value<V>>
+         && (!std::random_access_iterator<It> || !std::random_access_iterator<Out>)
+inline Out exclusive_scan(ExecutionPolicy&&, It first, It last, Out out,
+                          std::type_identity_t<V> init)
+{
+    return compensated::exclusive_scan(first, last, out, init);
+}
+#endif
+
+//=============================================================================================
+/**
+ * @class
+ * class `rolling_value` - a compensated sum over a sliding window of the
+ * most recent values pushed into it.
+ * @param
+ * The first template parameter is the underlying "raw" value type.
+ * The second one is the width of the window, or std::dynamic_extent if the
+ * width is given at run time to the constructor.
+ * The third template parameter selects the summation algorithm.
+ *
+ * The values in the window are kept in a ring buffer. Each push adds the
+ * new value to a compensated sum and subtracts the value leaving the window.
+ * Once per width's worth of pushes, the sum is recomputed from the buffer,
+ * so that its error depends only on the values in the window, and not on
+ * the history of the stream; the updates cost O(1) amortized.
+ */
+template<kahanizable V, std::size_t N = std::dynamic_extent,
+         algorithm A = default_algorithm<V>>
+requires supports_algorithm<V, A> && (N > 0)
+class rolling_value
+{
+private:
+    using buffer_type = std::conditional_t<N == std::dynamic_extent,
+                                           std::vector<V>,
+                                           std::array<V, N>>;
+    buffer_type Window;    // the ring buffer of values
+    std::size_t Next = 0;  // the position of the oldest value, to be replaced next
+    std::size_t Count = 0; // the number of values in the window
+    std::size_t Ticks = 0; // the number of pushes since the sum was recomputed
+    value<V, A> Sum;       // the sum of the values in the window
+
+public:
+    /**
+     * @brief Constructs an empty window of compile-time width
+     */
+    rolling_value()
+    requires (N != std::dynamic_extent)
+    {
+        clear();
+    }
+
+    /**
+     * @brief Constructs an empty window of the given width, which must be positive
+     */
+    explicit rolling_value(std::size_t width)
+    requires (N == std::dynamic_extent)
+        : Window(width)
+    {
+        assert(width > 0);
+        clear();
+    }
+
+//=== Observers ===
+
+    /**
+     * @brief Conversion operator to the raw value type: the sum of the window
+     */
+    inline operator V() const {return V(Sum);}
+
+    /**
+     * @brief The sum of the values in the window, as a compensated value
+     */
+    inline const value<V, A>& sum() const {return Sum;}
+
+    /**
+     * @brief The number of values which the window holds when full
+     */
+    inline std::size_t width() const {return Window.size();}
+
+    /**
+     * @brief The number of values currently in the window
+     */
+    inline std::size_t size() const {return Count;}
+
+//=== Updates ===
+
+    /**
+     * @brief Empties the window
+     */
+    inline void clear()
+    {
+        for (auto& slot : Window)
+            slot = 0;
+        Next = Count = Ticks = 0;
+        Sum = 0;
+    }
+
+    /**
+     * @brief Pushes a value into the window, which drops the oldest value
+     * if the window is full
+     */
+    inline void push(const V& x)
+    {
+        Sum -= Window[Next]; // zero if the window is not full yet
+        Sum += x;
+        Window[Next] = x;
+        if (++Next == width())
+            Next = 0;
+        if (Count < width())
+            Count++;
+        if (++Ticks == width())
+            recompute();
+    }
+
+    /**
+     * @brief Pushes a value into the window, which drops the oldest value
+     * if the window is full
+     */
+    inline void operator+= (const V& x)
+    {
+        push(x);
+    }
+
+    /**
+     * @brief Pushes an entire collection of values into the window, in order
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void push(It first, It last)
+    {
+        for (; first != last; ++first)
+            push(*first);
+    }
+
+    /**
+     * @brief Pushes an entire random-access range of values into the window,
+     * in order. The sums of the incoming values and of the values dropped
+     * from the window are computed with accumulate(), which is vectorized
+     * for contiguous floats and doubles, and then applied at once.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && std::random_access_iterator<It>
+    inline void push(It first, It last)
+    {
+        const auto count = static_cast<std::size_t>(last - first);
+        if (count >= width())
+        {   // Only the last values remain in the window
+            std::copy(last - width(), last, Window.begin());
+            Next = 0;
+            Count = width();
+            recompute();
+            return;
+        }
+
+        // The oldest `count` values, in at most two segments, leave the window:
+        const std::size_t head = std::min(count, width() - Next);
+        value<V, A> incoming, outgoing;
+        incoming.accumulate(first, last);
+        outgoing.accumulate(Window.begin() + Next, Window.begin() + Next + head);
+        outgoing.accumulate(Window.begin(), Window.begin() + (count - head));
+        Sum += incoming;
+        Sum -= outgoing;
+
+        std::copy(first, first + head, Window.begin() + Next);
+        std::copy(first + head, last, Window.begin());
+        Next = (Next + count) % width();
+        Count = std::min(width(), Count + count);
+        Ticks += count;
+        if (Ticks >= width())
+            recompute();
+    }
+
+private:
+    /**
+     * @brief Recomputes the sum from the values in the window
+     */
+    inline void recompute()
+    {
+        value<V, A> fresh;
+        fresh.accumulate(Window.begin(), Window.end());
+        Sum = fresh;
+        Ticks = 0;
+    }
+}; // class rolling_value
+
+//=============================================================================================
+/**
+ * @class
+ * class `moments` - streaming statistics of a sequence of floats or doubles:
+ * the count, the mean, the central moments of orders 2 to 4 (hence the
+ * variance, skewness and kurtosis), the minimum and the maximum, all
+ * computed in a single pass.
+ *
+ * Single values are added with the updates of Welford and Pébay, and two
+ * partial states are merged with Pébay's formulas, so the statistics can be
+ * computed in parallel. The mean and the sums of powers of deviations are
+ * kept in compensated values. Contiguous ranges are processed in blocks
+ * small enough to stay in the cache: each block is summed with the
+ * vectorized kernel to find its mean, the powers of the deviations from
+ * that mean are summed in vector lanes, and the block is then merged.
+ */
+template<std::floating_point V>
+class moments
+{
+private:
+    std::size_t Count = 0;                           // the number of values
+    value<V> Mean;                                   // their mean
+    value<V> M2, M3, M4;                             // the sums of powers of deviations from the mean
+    V Min = std::numeric_limits<V>::infinity();      // the smallest value
+    V Max = -std::numeric_limits<V>::infinity();     // the largest value
+
+    // The number of values in each block processed by the vectorized path
+    static constexpr std::size_t block_size = 2048;
+
+public:
+    constexpr moments() = default;
+
+//=== Statistics ===
+
+    /**
+     * @brief The number of values
+     */
+    inline std::size_t count() const {return Count;}
+
+    /**
+     * @brief The arithmetic mean
+     */
+    inline V mean() const {return V(Mean);}
+
+    /**
+     * @brief The population variance (the second central moment)
+     */
+    inline V variance() const {return V(M2) / V(Count);}
+
+    /**
+     * @brief The sample variance, with Bessel's correction
+     */
+    inline V sample_variance() const {return V(M2) / V(Count - 1);}
+
+    /**
+     * @brief The population standard deviation
+     */
+    inline V standard_deviation() const {return std::sqrt(variance());}
+
+    /**
+     * @brief The population skewness, i.e., the third standardized moment
+     */
+    inline V skewness() const
+    {
+        const V m2 = V(M2);
+        return std::sqrt(V(Count)) * V(M3) / (m2 * std::sqrt(m2));
+    }
+
+    /**
+     * @brief The population kurtosis, i.e., the fourth standardized moment
+     */
+    inline V kurtosis() const
+    {
+        const V m2 = V(M2);
+        return V(Count) * V(M4) / (m2 * m2);
+    }
+
+    /**
+     * @brief The population excess kurtosis, which is zero for normal distributions
+     */
+    inline V excess_kurtosis() const {return kurtosis() - 3;}
+
+    /**
+     * @brief The smallest value (+infinity if there are no values)
+     */
+    inline V min() const {return Min;}
+
+    /**
+     * @brief The largest value (-infinity if there are no values)
+     */
+    inline V max() const {return Max;}
+
+//=== Updates ===
+
+    /**
+     * @brief Adds a value, with the update formulas of Welford and Pébay
+     */
+    inline void operator+= (V x)
+    {
+        const V previous_count = V(Count);
+        Count++;
+        const V n = V(Count);
+        // The deviation from the compensated mean, not from the rounded one:
+        value<V> deviation = -Mean;
+        deviation += x;
+        const V delta = V(deviation);
+        const V delta_n = delta / n;
+        const V delta_n2 = delta_n * delta_n;
+        const V term = delta * delta_n * previous_count;
+        const V m2 = V(M2), m3 = V(M3);
+        Mean += delta_n;
+        M4 += term * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * m2 - 4 * delta_n * m3;
+        M3 += term * delta_n * (n - 2) - 3 * delta_n * m2;
+        M2 += term;
+        Min = std::min(Min, x);
+        Max = std::max(Max, x);
+    }
+
+    /**
+     * @brief Merges the statistics of another sequence, with Pébay's formulas
+     */
+    inline void operator+= (const moments& other)
+    {
+        if (other.Count == 0)
+            return;
+        if (Count == 0)
+        {
+            *this = other;
+            return;
+        }
+        const V na = V(Count), nb = V(other.Count);
+        const V n = na + nb;
+        value<V> mean_difference = other.Mean;
+        mean_difference -= Mean;
+        const V delta = V(mean_difference);
+        const V delta2 = delta * delta;
+        const V m2a = V(M2), m2b = V(other.M2);
+        const V m3a = V(M3), m3b = V(other.M3);
+
+        Count += other.Count;
+        Mean += delta * (nb / n);
+        M4 += other.M4;
+        M4 += delta2 * delta2 * (na * nb * (na * na - na * nb + nb * nb) / (n * n * n))
+            + 6 * delta2 * (na * na * m2b + nb * nb * m2a) / (n * n)
+            + 4 * delta * (na * m3b - nb * m3a) / n;
+        M3 += other.M3;
+        M3 += delta2 * delta * (na * nb * (na - nb) / (n * n))
+            + 3 * delta * (na * m2b - nb * m2a) / n;
+        M2 += other.M2;
+        M2 += delta2 * (na * nb / n);
+        Min = std::min(Min, other.Min);
+        Max = std::max(Max, other.Max);
+    }
+
+    /**
+     * @brief Adds an entire collection of values
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        for (; first != last; ++first)
+            operator+=(V(*first));
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of values, in blocks processed
+     * by the vectorized kernels
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && is_contiguous_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        const V* data = std::to_address(first);
+        const auto count = static_cast<std::size_t>(last - first);
+        for (std::size_t i = 0; i < count; i += block_size)
+            add_block(data + i, std::min(block_size, count - i));
+    }
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+    /**
+     * @brief Adds an entire collection of values under a standard execution
+     * policy: the partial statistics of fixed chunks are merged in order
+     * @param policy - the execution policy
+     * @param first - the random-access iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename ExecutionPolicy, typename It>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+             && is_iterator_to<It, V> && std::random_access_iterator<It>
+    inline void accumulate(ExecutionPolicy&& policy, It first, It last)
+    {
+        detail::parallel_accumulate(*this, std::forward<ExecutionPolicy>(policy),
+                                    first, last);
+    }
+#endif
+
+private:
+    /**
+     * @brief Merges the statistics of a block of contiguous values. The
+     * powers of the deviations are taken from the block mean rounded to V,
+     * and then corrected for the difference from the exact block mean.
+     */
+    inline void add_block(const V* data, std::size_t count)
+    {
+        V sum, compensation;
+        detail::sum_kernel(data, count, sum, compensation);
+        const V n = V(count);
+        const V center = (sum + compensation) / n;
+        V sums[4];
+        moments block;
+        detail::deviation_power_sums(data, count, center, sums, block.Min, block.Max);
+
+        const V e = sums[0] / n; // the exact block mean minus the center
+        const V e2 = e * e;
+        block.Count = count;
+        block.Mean = center;
+        block.Mean += e;
+        block.M2 = sums[1];
+        block.M2 -= n * e2;
+        block.M3 = sums[2];
+        block.M3 += e * (2 * n * e2 - 3 * sums[1]);
+        block.M4 = sums[3];
+        block.M4 += e * (6 * e * sums[1] - 4 * sums[2] - 3 * n * e2 * e);
+        operator+=(block);
+    }
+}; // class moments
+
+//=============================================================================================
+/**
+ * @class
+ * class `value_array` - a fixed-size array of compensated sums of floats or
+ * doubles, stored as a structure of arrays: the sums and the compensations
+ * are held in two separate arrays aligned to cache lines.
+ *
+ * Unlike a std::vector of `value` objects, which interleaves the sums and the
+ * compensations, this layout lets whole vectors of increments be added
+ * element-wise with vector instructions. Each element behaves exactly
+ * like a `value<V>`: the updates give the same results bit for bit.
+ */
+template<std::floating_point V>
+class value_array
+{
+private:
+    using storage = std::vector<V, detail::aligned_allocator<V>>;
+    storage Sums;          // the sums
+    storage Compensations; // the running compensations
+
+public:
+    // Constructors of an empty array and of an array of zeros:
+    value_array() = default;
+    explicit value_array(std::size_t size) : Sums(size), Compensations(size) {}
+
+//=== Size ===
+
+    /**
+     * @brief The number of compensated sums in the array
+     */
+    inline std::size_t size() const {return Sums.size();}
+
+    /**
+     * @brief Changes the number of compensated sums; new ones are zero
+     */
+    inline void resize(std::size_t size)
+    {
+        Sums.resize(size);
+        Compensations.resize(size);
+    }
+
+    /**
+     * @brief Sets all the sums to zero
+     */
+    inline void clear()
+    {
+        std::fill(Sums.begin(), Sums.end(), V(0));
+        std::fill(Compensations.begin(), Compensations.end(), V(0));
+    }
+
+//=== Element access ===
+
+    /**
+     * @brief The i-th sum, as a compensated value
+     */
+    inline value<V> operator[] (std::size_t i) const
+    {
+        assert(i < size());
+        value<V> result{Sums[i]};
+        result += Compensations[i];
+        return result;
+    }
+
+    /**
+     * @brief Sets the i-th sum to a compensated value
+     */
+    inline void set(std::size_t i, const value<V>& x)
+    {
+        assert(i < size());
+        Sums[i] = V(x);
+        Compensations[i] = x.error();
+    }
+
+    /**
+     * @brief The array of the sums, without their compensations
+     */
+    inline std::span<const V> sums() const {return Sums;}
+
+    /**
+     * @brief The array of the running compensations
+     */
+    inline std::span<const V> compensations() const {return Compensations;}
+
+//=== Element-wise updates ===
+
+    /**
+     * @brief Adds the i-th element of `increments` to the i-th sum, for each i;
+     * `increments` must have as many elements as the array. Like the indices
+     * of the sums, this is checked by an assertion; when assertions are
+     * disabled, the extra elements of the longer one are ignored.
+     */
+    inline void operator+= (std::span<const V> increments)
+    {
+        assert(increments.size() == size());
+        detail::elementwise_add<V, false>(Sums.data(), Compensations.data(),
+                                          increments.data(), std::min(size(), increments.size()));
+    }
+
+    /**
+     * @brief Subtracts the i-th element of `decrements` from the i-th sum, for each i;
+     * `decrements` must have as many elements as the array (see operator+=)
+     */
+    inline void operator-= (std::span<const V> decrements)
+    {
+        assert(decrements.size() == size());
+        detail::elementwise_add<V, true>(Sums.data(), Compensations.data(),
+                                         decrements.data(), std::min(size(), decrements.size()));
+    }
+
+    /**
+     * @brief Adds every element of another array, of the same size,
+     * to the corresponding sum
+     */
+    inline void operator+= (const value_array& other)
+    {
+        assert(other.size() == size());
+        // As in value::operator+=, the sum is added first, then the compensation
+        const std::size_t count = std::min(size(), other.size());
+        detail::elementwise_add<V, false>(Sums.data(), Compensations.data(),
+                                          other.Sums.data(), count);
+        detail::elementwise_add<V, false>(Sums.data(), Compensations.data(),
+                                          other.Compensations.data(), count);
+    }
+
+    /**
+     * @brief Adds a single value to the i-th sum
+     */
+    inline void add(std::size_t i, V increment)
+    {
+        assert(i < size());
+        detail::two_sum_step(Sums[i], Compensations[i], increment);
+    }
+
+    /**
+     * @brief Adds the k-th element of `increments` to the (first + k)-th sum,
+     * for each k, element-wise with vector instructions
+     */
+    inline void add(std::size_t first, std::span<const V> increments)
+    {
+        if (first < size())
+            detail::elementwise_add<V, false>(Sums.data() + first, Compensations.data() + first,
+                                              increments.data(),
+                                              std::min(size() - first, increments.size()));
+    }
+
+    /**
+     * @brief Scatter update: for each k, adds the k-th value to the sum
+     * whose index is the k-th index. Indices may repeat; the updates are
+     * then applied in order.
+     * @param first_index - the iterator to the beginning of the indices
+     * @param last_index  - the iterator to "one-past" the last index
+     * @param first_value - the iterator to the beginning of the values
+     */
+    template<typename ItI, typename ItV>
+    requires is_iterator_to<ItI, std::size_t> && is_iterator_to<ItV, V>
+    inline void add_at(ItI first_index, ItI last_index, ItV first_value)
+    {
+        for (; first_index != last_index; ++first_index, ++first_value)
+            add(static_cast<std::size_t>(*first_index), V(*first_value));
+    }
+
+    /**
+     * @brief Scatter update: for each k, subtracts the k-th value from the
+     * sum whose index is the k-th index
+     */
+    template<typename ItI, typename ItV>
+    requires is_iterator_to<ItI, std::size_t> && is_iterator_to<ItV, V>
+    inline void subtract_at(ItI first_index, ItI last_index, ItV first_value)
+    {
+        for (; first_index != last_index; ++first_index, ++first_value)
+            add(static_cast<std::size_t>(*first_index), -V(*first_value));
+    }
+
+//=== Export ===
+
+    /**
+     * @brief Gather: writes the rounded values of the sums at the given indices
+     * @return the iterator past the last value written
+     */
+    template<typename ItI, typename Out>
+    requires is_iterator_to<ItI, std::size_t> && std::output_iterator<Out, V>
+    inline Out gather(ItI first_index, ItI last_index, Out out) const
+    {
+        for (; first_index != last_index; ++first_index, ++out)
+        {
+            const auto i = static_cast<std::size_t>(*first_index);
+            assert(i < size());
+            *out = Sums[i] + Compensations[i];
+        }
+        return out;
+    }
+
+    /**
+     * @brief Writes the rounded values of all the sums, in bulk
+     * @param out - the array receiving them, with at least size() elements
+     */
+    inline void round(std::span<V> out) const
+    {
+        detail::elementwise_round(Sums.data(), Compensations.data(), out.data(),
+                                  std::min(size(), out.size()));
+    }
+
+    /**
+     * @brief Returns the rounded values of all the sums
+     */
+    inline std::vector<V> round() const
+    {
+        std::vector<V> result(size());
+        round(result);
+        return result;
+    }
+}; // class value_array
+
+//=============================================================================================
+/*
+ * Internal helper of the reductions along an axis.
+ */
+namespace detail
+{
+/**
+ * @brief Adds each element of an N-dimensional strided array to `result`,
+ * at the index of the element with the coordinate along `axis` removed
+ * (row-major with respect to the remaining axes).
+ *
+ * The array is traversed in memory order: the axes are visited from the
+ * largest to the smallest stride, and the innermost one is handled in runs.
+ * A contiguous run either reduces into a single sum, with the vectorized
+ * summation kernel, or is added element-wise to a contiguous run of sums.
+ */
+template<std::floating_point V, std::size_t N>
+inline void reduce_axis(const V* data, const std::array<std::size_t, N>& extents,
+                        const std::array<std::ptrdiff_t, N>& strides, std::size_t axis,
+                        value_array<V>& result)
+{
+    assert(axis < N);
+    std::array<std::size_t, N> out_strides{};
+    std::size_t out_size = 1;
+    for (std::size_t d = N; d-- > 0;)
+    {
+        if (d != axis)
+        {
+            out_strides[d] = out_size;
+            out_size *= extents[d];
+        }
+    }
+    result = value_array<V>(out_size);
+    if (std::find(extents.begin(), extents.end(), std::size_t{0}) != extents.end())
+        return;
+
+    std::array<std::size_t, N> order;
+    for (std::size_t d = 0; d < N; d++)
+        order[d] = d;
+    std::stable_sort(order.begin(), order.end(), [&strides](std::size_t a, std::size_t b)
+    {
+        return std::abs(strides[a]) > std::abs(strides[b]);
+    });
+
+    const std::size_t inner = order[N - 1];
+    const std::size_t run = extents[inner];
+    const std::ptrdiff_t in_step = strides[inner];
+    const std::size_t out_step = out_strides[inner];
+
+    std::array<std::size_t, N> index{};
+    std::ptrdiff_t in_offset = 0;
+    std::size_t out_offset = 0;
+    for (;;)
+    {
+        const V* row = data + in_offset;
+        if (out_step == 0 && in_step == 1)
+        {   // A contiguous run along the reduced axis
+            V sum, compensation;
+            sum_kernel(row, run, sum, compensation);
+            result.add(out_offset, sum);
+            result.add(out_offset, compensation);
+        }
+        else if (out_step == 1 && in_step == 1)
+            result.add(out_offset, std::span<const V>(row, run));
+        else
+        {
+            for (std::size_t k = 0; k < run; k++)
+                result.add(out_offset + k * out_step, row[static_cast<std::ptrdiff_t>(k) * in_step]);
+        }
+
+        // Move on to the next run, as in an odometer
+        std::size_t position = N - 1;
+        for (;;)
+        {
+            if (position == 0)
+                return;
+            const std::size_t d = order[--position];
+            if (++index[d] < extents[d])
+            {
+                in_offset += strides[d];
+                out_offset += out_strides[d];
+                break;
+            }
+            in_offset -= strides[d] * static_cast<std::ptrdiff_t>(extents[d] - 1);
+            out_offset -= out_strides[d] * (extents[d] - 1);
+            index[d] = 0;
+        }
+    }
+}
+} // namespace detail
+
+/**
+ * @brief Compensated sums of an N-dimensional array along one of its axes,
+ * e.g. the column sums (axis 0) or the row sums (axis 1) of a table.
+ * The array is traversed in memory order, so that the sums of the columns of
+ * a row-major table are updated a whole row at a time, with vector
+ * instructions, rather than by walking each column across cache lines.
+ * @param data    - pointer to the element with all coordinates zero
+ * @param extents - the extents of the array, e.g. {rows, columns}
+ * @param strides - the distances (in elements, possibly negative) between
+ *                  consecutive elements along each axis
+ * @param axis    - the axis to reduce, less than N
+ * @return the array of the sums, indexed by the remaining coordinates in
+ * row-major order; for a table, the sums of its columns or of its rows
+ */
+template<std::floating_point V, std::size_t N>
+inline value_array<V> reduce(const V* data, const std::size_t (&extents)[N],
+                             const std::ptrdiff_t (&strides)[N], std::size_t axis)
+{
+    value_array<V> result;
+    detail::reduce_axis(data, std::to_array(extents), std::to_array(strides), axis, result);
+    return result;
+}
+
+/**
+ * @brief Compensated sums of a contiguous N-dimensional array in row-major
+ * order (the last coordinate varies fastest) along one of its axes
+ * @param data    - pointer to the first element
+ * @param extents - the extents of the array, e.g. {rows, columns}
+ * @param axis    - the axis to reduce, less than N
+ */
+template<std::floating_point V, std::size_t N>
+inline value_array<V> reduce(const V* data, const std::size_t (&extents)[N], std::size_t axis)
+{
+    std::array<std::ptrdiff_t, N> strides;
+    std::ptrdiff_t stride = 1;
+    for (std::size_t d = N; d-- > 0;)
+    {
+        strides[d] = stride;
+        stride *= static_cast<std::ptrdiff_t>(extents[d]);
+    }
+    value_array<V> result;
+    detail::reduce_axis(data, std::to_array(extents), strides, axis, result);
+    return result;
+}
+
+#if defined(__cpp_lib_mdspan)
+/**
+ * @brief Compensated sums of a std::mdspan with a strided layout (such as
+ * std::layout_right or std::layout_left) along one of its axes
+ * @param array - the multidimensional view
+ * @param axis  - the axis to reduce, less than its rank
+ */
+template<typename T, typename Extents, typename Layout>
+requires std::floating_point<std::remove_const_t<T>>
+inline value_array<std::remove_const_t<T>>
+reduce(std::mdspan<T, Extents, Layout, std::default_accessor<T>> array, std::size_t axis)
+{
+    constexpr std::size_t N = Extents::rank();
+    std::array<std::size_t, N> extents;
+    std::array<std::ptrdiff_t, N> strides;
+    for (std::size_t d = 0; d < N; d++)
+    {
+        extents[d] = static_cast<std::size_t>(array.extent(d));
+        strides[d] = static_cast<std::ptrdiff_t>(array.stride(d));
+    }
+    value_array<std::remove_const_t<T>> result;
+    detail::reduce_axis<std::remove_const_t<T>, N>(array.data_handle(), extents, strides, axis, result);
+    return result;
+}
+#endif
+
+//=============================================================================================
+/*
+ * Internal helper of `widened_value`: the type in which values of a narrow
+ * floating-point type are accumulated.
+ */
+namespace detail
+{
+template<typename V>
+struct wider {};
+
+template<>
+struct wider<float> {using type = double;};
+
+template<typename V>
+requires is_half_precision<V>
+struct wider<V> {using type = float;};
+} // namespace detail
+
+/**
+ * @brief The concept of a floating-point type with a wider type for its sums
+ */
+template<typename V>
+concept widenable = (std::floating_point<V> || is_half_precision<V>) && requires {typename detail::wider<V>::type;};
+
+/**
+ * @class
+ * class `widened_value` - a sum of values of a narrow floating-point type
+ * (float, or a 16-bit type such as _Float16), accumulated in a wider type
+ * (double, or float for the 16-bit types) and rounded back to the narrow
+ * type only when it is read.
+ * @param
+ * The first template parameter is the narrow "raw" value type.
+ * The second template parameter selects the algorithm used in the wide type;
+ * by default, none (plain summation).
+ *
+ * With 29 more bits of precision, a plain sum of floats in a double is
+ * usually as accurate as a compensated sum in float, and the contiguous
+ * ranges are summed by a vectorized kernel which converts the floats as
+ * it loads them. Since the conversion halves the number of lanes per vector
+ * register, either mode may be faster on a given machine: the choice is left
+ * to the call site, e.g., `widened_value<float>` versus `value<float>`.
+ * For sums with massive cancellation, a compensated algorithm can be used in
+ * the wide type, e.g., `widened_value<float, algorithm::neumaier>`.
+ */
+template<widenable V, algorithm A = algorithm::naive>
+class widened_value
+{
+public:
+    /**
+     * @brief The type of the accumulated sum
+     */
+    using wide_type = typename detail::wider<V>::type;
+
+private:
+    value<wide_type, A> Total;
+
+public:
+    // Constructors from nothing and from V:
+    constexpr widened_value() = default;
+    explicit constexpr widened_value(V initial_value) : Total{wide_type(initial_value)} {}
+
+    /**
+     * @brief The sum rounded to the narrow type
+     */
+    inline explicit operator V() const {return static_cast<V>(static_cast<wide_type>(Total));}
+
+    /**
+     * @brief The sum in the wide type, with its compensation if any
+     */
+    inline const value<wide_type, A>& wide() const {return Total;}
+
+    /**
+     * @brief Adds a raw value
+     */
+    inline void operator+= (V increment) {Total += wide_type(increment);}
+
+    /**
+     * @brief Subtracts a raw value
+     */
+    inline void operator-= (V decrement) {Total -= wide_type(decrement);}
+
+    /**
+     * @brief Adds another widened sum
+     */
+    inline void operator+= (const widened_value& other) {Total += other.Total;}
+
+    /**
+     * @brief Adds an entire collection of raw values
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        for (; first != last; ++first)
+            Total += wide_type(V(*first));
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of raw values, with the
+     * vectorized widening kernel
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && std::contiguous_iterator<It>
+             && std::same_as<std::iter_value_t<It>, V>
+    inline void accumulate(It first, It last)
+    {
+        if (first == last)
+            return;
+        wide_type sum, compensation;
+        detail::dispatch([&]<std::size_t bytes, bool>() COMPENSATED_KERNEL_INLINE
+        {
+            detail::converting_sum_kernel<wide_type, V, A != algorithm::naive,
+                                          detail::lanes_in<wide_type, bytes>>(
+                std::to_address(first), static_cast<std::size_t>(last - first),
+                sum, compensation);
+        });
+        Total += sum;
+        Total += compensation;
+    }
+
+    /**
+     * @brief Adds all the elements of a range, such as a container or a view
+     * @param range - the range of values to be added
+     */
+    template<typename R>
+    requires is_range_of<R, V>
+    inline void accumulate(R&& range)
+    {
+        if constexpr (std::ranges::common_range<R>)
+            accumulate(std::ranges::begin(range), std::ranges::end(range));
         else
-            Compensation = Compensation + ((increment - naive_sum) + Sum);
-        Sum = naive_sum;
+        {
+            for (auto&& x : range)
+                Total += wide_type(V(x));
+        }
+    }
+}; // class widened_value
+
+//=============================================================================================
+/*
+ * Internal helpers: storage of trivially copyable objects with atomic
+ * compare-and-swap operations on their whole representation.
+ */
+namespace detail
+{
+/**
+ * @brief Atomic storage protected by a spin lock: the fallback for objects
+ * for which no compare-and-swap instruction is available
+ */
+template<typename T>
+class atomic_storage
+{
+private:
+    mutable std::atomic_flag Lock = ATOMIC_FLAG_INIT;
+    T Object;
+
+    inline void lock() const
+    {
+        while (Lock.test_and_set(std::memory_order_acquire))
+            ; // spin
+    }
+
+    inline void unlock() const
+    {
+        Lock.clear(std::memory_order_release);
+    }
+
+public:
+    static constexpr bool lock_free = false;
+
+    explicit atomic_storage(const T& initial) : Object{initial} {}
+
+    inline bool is_lock_free() const {return false;}
+
+    inline T load() const
+    {
+        lock();
+        T result = Object;
+        unlock();
+        return result;
+    }
+
+    /**
+     * @brief Replaces the object with `desired` if it is bitwise equal to
+     * `expected`; otherwise, loads the object into `expected`
+     */
+    inline bool compare_exchange(T& expected, const T& desired)
+    {
+        lock();
+        const bool equal = std::memcmp(&Object, &expected, sizeof(T)) == 0;
+        if (equal)
+            Object = desired;
+        else
+            expected = Object;
+        unlock();
+        return equal;
+    }
+};
+
+/**
+ * @brief Lock-free atomic storage of 8-byte objects, such as value<float>
+ */
+template<typename T>
+requires (sizeof(T) == 8)
+class atomic_storage<T>
+{
+private:
+    std::atomic<std::uint64_t> Word;
+
+public:
+    static constexpr bool lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+    explicit atomic_storage(const T& initial) : Word{std::bit_cast<std::uint64_t>(initial)} {}
+
+    inline bool is_lock_free() const {return Word.is_lock_free();}
+
+    inline T load() const
+    {
+        return std::bit_cast<T>(Word.load());
+    }
+
+    inline bool compare_exchange(T& expected, const T& desired)
+    {
+        auto expected_word = std::bit_cast<std::uint64_t>(expected);
+        const bool exchanged = Word.compare_exchange_weak(expected_word,
+                                                          std::bit_cast<std::uint64_t>(desired));
+        expected = std::bit_cast<T>(expected_word);
+        return exchanged;
+    }
+};
+
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))) \
+    || (defined(_MSC_VER) && defined(_M_X64))
+#if defined(__GNUC__) && defined(__x86_64__)
+/**
+ * @brief Whether the processor has the 16-byte compare-and-swap instruction
+ * cmpxchg16b, which only the earliest x86-64 processors lack
+ */
+inline bool has_cmpxchg16b()
+{
+    static const bool supported = []
+    {
+        unsigned eax, ebx, ecx, edx;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_CMPXCHG16B) != 0;
+    }();
+    return supported;
+}
+
+/**
+ * @brief The spin lock which guards the 16-byte atomic storage at `address`
+ * on processors without cmpxchg16b: one of a fixed set of locks, shared by
+ * all such objects
+ */
+inline std::atomic_flag& address_lock(const void* address)
+{
+    static std::atomic_flag locks[64];
+    return locks[(reinterpret_cast<std::uintptr_t>(address) / 16) % 64];
+}
+#endif
+
+/**
+ * @brief Atomic storage of 16-byte objects, such as value<double>, using the
+ * double-width compare-and-swap instruction (cmpxchg16b on x86-64, casp or
+ * an exclusive pair of loads and stores on AArch64).
+ *
+ * GCC and Clang inline cmpxchg16b only when compiling with -mcx16, so on
+ * x86-64 it is issued directly, and its availability is checked at run time;
+ * this way, neither the layout nor the code depends on the compiler flags.
+ * The processors without the instruction use a spin lock instead.
+ */
+template<typename T>
+requires (sizeof(T) == 16)
+class atomic_storage<T>
+{
+private:
+    struct alignas(16) words {std::uint64_t low, high;};
+    mutable words Word; // Also written by load(), see below
+
+    /**
+     * @brief Replaces the storage with `desired` if it is equal to `expected`;
+     * otherwise, loads the storage into `expected`
+     * @return whether the storage was replaced
+     */
+    inline bool compare_and_swap(words& expected, const words& desired) const
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(&Word),
+                                              static_cast<long long>(desired.high),
+                                              static_cast<long long>(desired.low),
+                                              reinterpret_cast<long long*>(&expected)) != 0;
+#elif defined(__aarch64__)
+        using wide = unsigned __int128;
+        const wide previous = __sync_val_compare_and_swap(reinterpret_cast<wide*>(&Word),
+                                                          std::bit_cast<wide>(expected),
+                                                          std::bit_cast<wide>(desired));
+        const bool equal = previous == std::bit_cast<wide>(expected);
+        expected = std::bit_cast<words>(previous);
+        return equal;
+#else
+        if (has_cmpxchg16b())
+        {
+            bool equal;
+            __asm__ __volatile__("lock cmpxchg16b %1"
+                                 : "=@ccz"(equal), "+m"(Word),
+                                   "+a"(expected.low), "+d"(expected.high)
+                                 : "b"(desired.low), "c"(desired.high)
+                                 : "memory");
+            return equal;
+        }
+        std::atomic_flag& lock = address_lock(&Word);
+        while (lock.test_and_set(std::memory_order_acquire))
+            ; // spin
+        const bool equal = Word.low == expected.low && Word.high == expected.high;
+        if (equal)
+            Word = desired;
+        else
+            expected = Word;
+        lock.clear(std::memory_order_release);
+        return equal;
+#endif
+    }
+
+public:
+#if defined(__GNUC__) && defined(__x86_64__)
+    static constexpr bool lock_free = false; // Known only at run time
+#else
+    static constexpr bool lock_free = true;
+#endif
+
+    explicit atomic_storage(const T& initial) : Word{std::bit_cast<words>(initial)} {}
+
+    inline bool is_lock_free() const
+    {
+#if defined(__GNUC__) && defined(__x86_64__)
+        return has_cmpxchg16b();
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Reads the object with a compare-and-swap, which stores back
+     * what it finds. Although the object does not change, the storage is
+     * written to, so it must not be in read-only memory, and concurrent
+     * readers contend for its cache line like writers do.
+     */
+    inline T load() const
+    {
+        const words zero{0, 0};
+        words found = zero;
+        compare_and_swap(found, zero);
+        return std::bit_cast<T>(found);
+    }
+
+    inline bool compare_exchange(T& expected, const T& desired)
+    {
+        words expected_words = std::bit_cast<words>(expected);
+        const bool exchanged = compare_and_swap(expected_words, std::bit_cast<words>(desired));
+        expected = std::bit_cast<T>(expected_words);
+        return exchanged;
+    }
+};
+#endif
+} // namespace detail
+
+//=============================================================================================
+/**
+ * @class
+ * class `atomic_value` - a compensated sum shared between threads, updated
+ * with atomic read-modify-write operations.
+ * @param
+ * The first template parameter is the underlying "raw" value type.
+ * The second template parameter selects the summation algorithm.
+ *
+ * The sum and the compensation of a `value<V, A>` are stored together and
+ * updated with a single compare-and-swap of their whole representation,
+ * so that concurrent updates are never torn. For floats, the pair fits in a
+ * 64-bit word. For doubles, it takes a 128-bit compare-and-swap (cmpxchg16b on
+ * x86-64), which is also used to read the value; processors without such an
+ * instruction use a spin lock instead, as reported by is_lock_free(). Since
+ * the earliest x86-64 processors lack cmpxchg16b, it is looked for at run
+ * time there, and is_always_lock_free is false.
+ *
+ * Under heavy contention, every update retries its compare-and-swap until
+ * no other thread has intervened. Threads adding many values should sum
+ * them into their own `value` objects first, and then add those with
+ * a single fetch_add().
+ */
+template<std::floating_point V, algorithm A = default_algorithm<V>>
+class atomic_value
+{
+private:
+    detail::atomic_storage<value<V, A>> Storage;
+
+    /**
+     * @brief Applies `update` to the stored value atomically
+     * @return the value before the update
+     */
+    template<typename Update>
+    inline value<V, A> read_modify_write(Update update)
+    {
+        value<V, A> expected = Storage.load();
+        value<V, A> desired;
+        do
+        {
+            desired = expected;
+            update(desired);
+        }
+        while (!Storage.compare_exchange(expected, desired));
+        return expected;
+    }
+
+public:
+    /**
+     * @brief Whether the updates are lock-free
+     */
+    static constexpr bool is_always_lock_free = detail::atomic_storage<value<V, A>>::lock_free;
+
+    /**
+     * @brief Whether the updates are lock-free on the present processor
+     */
+    inline bool is_lock_free() const {return Storage.is_lock_free();}
+
+    // Constructors from nothing, from V and from a compensated value:
+    atomic_value() : Storage{value<V, A>{}} {}
+    explicit atomic_value(V initial_value) : Storage{value<V, A>{initial_value}} {}
+    explicit atomic_value(const value<V, A>& initial_value) : Storage{initial_value} {}
+
+    // Like std::atomic, this class is neither copyable nor movable:
+    atomic_value(const atomic_value&) = delete;
+    atomic_value& operator=(const atomic_value&) = delete;
+
+    /**
+     * @brief Atomically reads the compensated value. For doubles, this is
+     * a compare-and-swap, which writes the unchanged value back.
+     */
+    inline value<V, A> load() const {return Storage.load();}
+
+    /**
+     * @brief Atomically reads the compensated value
+     */
+    inline operator value<V, A>() const {return load();}
+
+    /**
+     * @brief Atomically replaces the compensated value
+     */
+    inline void store(const value<V, A>& desired) {exchange(desired);}
+
+    /**
+     * @brief Atomically replaces the compensated value
+     * @return the previous value
+     */
+    inline value<V, A> exchange(const value<V, A>& desired)
+    {
+        return read_modify_write([&desired](value<V, A>& v) {v = desired;});
+    }
+
+    /**
+     * @brief Atomically adds a raw value, with compensation
+     * @return the previous value
+     */
+    inline value<V, A> fetch_add(V increment)
+    {
+        return read_modify_write([increment](value<V, A>& v) {v += increment;});
+    }
+
+    /**
+     * @brief Atomically adds another compensated value, such as a partial sum
+     * @return the previous value
+     */
+    inline value<V, A> fetch_add(const value<V, A>& increment)
+    {
+        return read_modify_write([&increment](value<V, A>& v) {v += increment;});
+    }
+
+    /**
+     * @brief Atomically subtracts a raw value, with compensation
+     * @return the previous value
+     */
+    inline value<V, A> fetch_sub(V decrement)
+    {
+        return read_modify_write([decrement](value<V, A>& v) {v -= decrement;});
+    }
+
+    /**
+     * @brief Atomically adds a raw value, with compensation
+     */
+    inline void operator+= (V increment) {fetch_add(increment);}
+
+    /**
+     * @brief Atomically subtracts a raw value, with compensation
+     */
+    inline void operator-= (V decrement) {fetch_sub(decrement);}
+
+    /**
+     * @brief Atomically adds another compensated value
+     */
+    inline void operator+= (const value<V, A>& increment) {fetch_add(increment);}
+}; // class atomic_value
+
+//=============================================================================================
+/*
+ * Internal helpers of `sharded_value`.
+ */
+namespace detail
+{
+/**
+ * @brief The alignment which keeps objects on separate cache lines. Two lines
+ * rather than one, since x86 processors prefetch adjacent pairs of lines.
+ */
+constexpr std::size_t false_sharing_bytes = 128;
+
+/**
+ * @brief The probe of the calling thread: a pseudo-random number, used for
+ * choosing a shard and changed whenever the shard turns out to be contended
+ */
+inline std::uint32_t& thread_probe()
+{
+    thread_local std::uint32_t probe = static_cast<std::uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+    return probe;
+}
+
+/**
+ * @brief Moves a thread to a different shard (xorshift step)
+ */
+inline void next_probe(std::uint32_t& probe)
+{
+    probe ^= probe << 13;
+    probe ^= probe >> 17;
+    probe ^= probe << 5;
+}
+} // namespace detail
+
+//=============================================================================================
+/**
+ * @class
+ * class `sharded_value` - a compensated sum updated by many threads at once,
+ * spread over several independently updated shards.
+ * @param
+ * The first template parameter is the underlying "raw" value type.
+ * The second template parameter selects the summation algorithm.
+ *
+ * Even with atomic updates, a single shared sum moves its cache line from
+ * core to core on every update. A `sharded_value` starts with a single
+ * atomic cell, like `atomic_value`. Once two threads collide on it, the
+ * updates spill over into an array of cells, each on its own cache line, and
+ * every thread picks a cell based on its thread id. The cells are created
+ * lazily, and their number doubles on every further collision, up to the
+ * number of hardware threads; this way, the cost of an update does not grow
+ * with the number of threads.
+ *
+ * Reading the sum merges the compensated values of all the cells. The result
+ * is exact with respect to the updates finished before the read; updates made
+ * concurrently with the read may or may not be included.
+ */
+template<std::floating_point V, algorithm A = default_algorithm<V>>
+class sharded_value
+{
+private:
+    using storage = detail::atomic_storage<value<V, A>>;
+
+    struct alignas(detail::false_sharing_bytes) cell
+    {
+        storage Sum;
+        explicit cell(const value<V, A>& initial_value = {}) : Sum{initial_value} {}
+    };
+
+    cell Base;                                  // Updated while there are no collisions
+    std::atomic<unsigned> Width{0};             // The number of cells in use
+    const unsigned Capacity;                    // The maximal number of cells
+    std::unique_ptr<std::atomic<cell*>[]> Cells;
+
+    /**
+     * @brief Applies `update` to the sum in `target` with a single attempt
+     * at compare-and-swap
+     * @return false if another thread has modified the sum in the meantime
+     */
+    template<typename Update>
+    static inline bool try_update(storage& target, Update update)
+    {
+        value<V, A> expected = target.load();
+        value<V, A> desired = expected;
+        update(desired);
+        return target.compare_exchange(expected, desired);
+    }
+
+    /**
+     * @brief Returns the cell with the given index, creating it if needed
+     */
+    inline cell& cell_at(unsigned index)
+    {
+        cell* result = Cells[index].load(std::memory_order_acquire);
+        if (!result)
+        {
+            cell* created = new cell;
+            if (Cells[index].compare_exchange_strong(result, created, std::memory_order_acq_rel))
+                result = created;
+            else // Another thread was faster:
+                delete created;
+        }
+        return *result;
+    }
+
+    /**
+     * @brief Doubles the number of cells in use, up to Capacity
+     * @return the current number of cells in use
+     */
+    inline unsigned widen(unsigned width)
+    {
+        const unsigned wider = width ? std::min(2 * width, Capacity) : std::min(2u, Capacity);
+        if (Width.compare_exchange_strong(width, wider, std::memory_order_acq_rel))
+            return wider;
+        return width; // Already widened by another thread
+    }
+
+    /**
+     * @brief Applies `update` to the sum in one of the cells
+     */
+    template<typename Update>
+    inline void modify(Update update)
+    {
+        unsigned width = Width.load(std::memory_order_acquire);
+        if (width == 0)
+        {
+            if (try_update(Base.Sum, update))
+                return;
+            width = widen(width);
+        }
+        std::uint32_t& probe = detail::thread_probe();
+        while (!try_update(cell_at(probe & (width - 1)).Sum, update))
+        {
+            if (width < Capacity)
+                width = widen(width);
+            detail::next_probe(probe);
+        }
+    }
+
+    /**
+     * @brief Replaces the sum in `target` with zero
+     */
+    static inline void reset(storage& target)
+    {
+        value<V, A> expected = target.load();
+        while (!target.compare_exchange(expected, value<V, A>{}))
+            ;
+    }
+
+public:
+    /**
+     * @brief Whether the updates are lock-free
+     */
+    static constexpr bool is_always_lock_free = storage::lock_free;
+
+    /**
+     * @brief Whether the updates are lock-free on the present processor
+     */
+    inline bool is_lock_free() const {return Base.Sum.is_lock_free();}
+
+    // Constructors from nothing, from V and from a compensated value:
+    sharded_value() : sharded_value(value<V, A>{}) {}
+    explicit sharded_value(V initial_value) : sharded_value(value<V, A>{initial_value}) {}
+    explicit sharded_value(const value<V, A>& initial_value)
+        : Base{initial_value}
+        , Capacity{std::bit_ceil(std::max(1u, std::thread::hardware_concurrency()))}
+        , Cells{new std::atomic<cell*>[Capacity]}
+    {
+        for (unsigned i = 0; i < Capacity; i++)
+            Cells[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~sharded_value()
+    {
+        for (unsigned i = 0; i < Capacity; i++)
+            delete Cells[i].load(std::memory_order_relaxed);
+    }
+
+    // Like atomic_value, this class is neither copyable nor movable:
+    sharded_value(const sharded_value&) = delete;
+    sharded_value& operator=(const sharded_value&) = delete;
+
+    /**
+     * @brief Adds a raw value, with compensation
+     */
+    inline void operator+= (V increment)
+    {
+        modify([increment](value<V, A>& v) {v += increment;});
+    }
+
+    /**
+     * @brief Subtracts a raw value, with compensation
+     */
+    inline void operator-= (V decrement)
+    {
+        modify([decrement](value<V, A>& v) {v -= decrement;});
+    }
+
+    /**
+     * @brief Adds another compensated value, such as a partial sum
+     */
+    inline void operator+= (const value<V, A>& increment)
+    {
+        modify([&increment](value<V, A>& v) {v += increment;});
+    }
+
+    /**
+     * @brief Merges the sums from all the cells
+     */
+    inline value<V, A> load() const
+    {
+        value<V, A> result = Base.Sum.load();
+        const unsigned width = Width.load(std::memory_order_acquire);
+        for (unsigned i = 0; i < width; i++)
+        {
+            if (const cell* shard = Cells[i].load(std::memory_order_acquire))
+                result += shard->Sum.load();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Merges the sums from all the cells
+     */
+    inline operator value<V, A>() const {return load();}
+
+    /**
+     * @brief Resets the sum to zero. Updates made concurrently with the
+     * reset may or may not survive it.
+     */
+    inline void clear()
+    {
+        reset(Base.Sum);
+        const unsigned width = Width.load(std::memory_order_acquire);
+        for (unsigned i = 0; i < width; i++)
+        {
+            if (cell* shard = Cells[i].load(std::memory_order_acquire))
+                reset(shard->Sum);
+        }
+    }
+
+    /**
+     * @brief Returns the number of cells in use besides the initial one
+     */
+    inline unsigned shards() const {return Width.load(std::memory_order_relaxed);}
+}; // class sharded_value
+
+//=============================================================================================
+/**
+ * @class
+ * class `seqlock_value` - a compensated sum updated by a single writer thread
+ * and read by any number of other threads, which never block the writer.
+ * @param
+ * The first template parameter is the underlying "raw" value type.
+ * The second template parameter selects the summation algorithm.
+ *
+ * The writer updates its private copy of the sum and publishes it under a
+ * sequence lock: the sequence number is odd while the published copy is
+ * being written. A reader copies the published sum and retries if the
+ * sequence number was odd or has changed in the meantime, so that it never
+ * sees the Sum of one update with the Compensation of another. Unlike
+ * `atomic_value`, this works for values of any size, such as those of
+ * std::complex<double>; the writer never waits, but the readers may have to
+ * retry while the writer is busy.
+ *
+ * All the modifying member functions must be called from one thread at a
+ * time; load() can be called from any thread.
+ */
+template<kahanizable V, algorithm A = default_algorithm<V>>
+requires supports_algorithm<V, A> && std::is_trivially_copyable_v<value<V, A>>
+class seqlock_value
+{
+private:
+    using word = std::uintptr_t;
+    static constexpr std::size_t word_count = (sizeof(value<V, A>) + sizeof(word) - 1) / sizeof(word);
+
+    std::atomic<unsigned> Sequence{0};  // Odd while the words are being written
+    std::atomic<word> Words[word_count];
+    value<V, A> Local;                  // The writer's copy
+
+    /**
+     * @brief Copies the writer's value to the words read by the readers
+     */
+    inline void publish()
+    {
+        word buffer[word_count] = {};
+        std::memcpy(buffer, &Local, sizeof(value<V, A>));
+
+        const unsigned sequence = Sequence.load(std::memory_order_relaxed);
+        Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < word_count; i++)
+            Words[i].store(buffer[i], std::memory_order_relaxed);
+        Sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+public:
+    // Constructors from nothing, from V and from a compensated value:
+    seqlock_value() : seqlock_value(value<V, A>{}) {}
+    explicit seqlock_value(V initial_value) : seqlock_value(value<V, A>{initial_value}) {}
+    explicit seqlock_value(const value<V, A>& initial_value) : Local{initial_value}
+    {
+        publish();
+    }
+
+    // Like atomic_value, this class is neither copyable nor movable:
+    seqlock_value(const seqlock_value&) = delete;
+    seqlock_value& operator=(const seqlock_value&) = delete;
+
+    /**
+     * @brief Reads a consistent snapshot of the compensated value, from any thread
+     */
+    inline value<V, A> load() const
+    {
+        word buffer[word_count];
+        for (;;)
+        {
+            const unsigned before = Sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue; // A write is in progress
+            for (std::size_t i = 0; i < word_count; i++)
+                buffer[i] = Words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+        value<V, A> result;
+        std::memcpy(&result, buffer, sizeof(value<V, A>));
+        return result;
+    }
+
+    /**
+     * @brief Reads a consistent snapshot of the compensated value, from any thread
+     */
+    inline operator value<V, A>() const {return load();}
+
+    /**
+     * @brief Replaces the compensated value (writer only)
+     */
+    inline void store(const value<V, A>& desired)
+    {
+        Local = desired;
+        publish();
+    }
+
+    /**
+     * @brief Adds a raw value, with compensation (writer only)
+     */
+    inline void operator+= (const V& increment)
+    {
+        Local += increment;
+        publish();
+    }
+
+    /**
+     * @brief Subtracts a raw value, with compensation (writer only)
+     */
+    inline void operator-= (const V& decrement)
+    {
+        Local -= decrement;
+        publish();
+    }
+
+    /**
+     * @brief Adds another compensated value, such as a partial sum (writer only)
+     */
+    inline void operator+= (const value<V, A>& increment)
+    {
+        Local += increment;
+        publish();
+    }
+
+    /**
+     * @brief Adds an entire collection of values and publishes the result
+     * once (writer only)
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        Local.accumulate(first, last);
+        publish();
+    }
+}; // class seqlock_value
+
+//=============================================================================================
+/*
+ * Internal parameters of the binned representation used by `reproducible`.
+ *
+ * The real line is divided into bins of `width` bits: the bin with index b
+ * holds multiples of 2^((b-1)*width) below 2^(b*width). An accumulator keeps
+ * `folds` consecutive bins, starting from the top bin which can hold the
+ * largest summand seen so far. Each summand is split exactly between these
+ * bins, and the bits below the lowest bin are discarded.
+ */
+namespace detail
+{
+struct binning
+{
+    // Number of bits in the significand of a double
+    static constexpr int precision = std::numeric_limits<double>::digits;
+    // Number of bits per bin
+    static constexpr int width = 40;
+    // Number of bins kept by an accumulator
+    static constexpr int folds = 3;
+    // Number of deposits into a bin between renormalizations
+    static constexpr int max_deposits = 1 << (precision - width - 3);
+    // Range of indices of the top bin, such that all the bins are normal numbers
+    static constexpr int lowest_bin = folds + (std::numeric_limits<double>::min_exponent
+                                               - precision) / width;
+    static constexpr int highest_bin = (std::numeric_limits<double>::max_exponent
+                                        + width - precision) / width;
+
+    /**
+     * @brief The bin of index b holds the sum of its summands added to the
+     * extractor 1.5 * 2^(precision - 1 + (b-1)*width), so that adding a
+     * summand rounds it to a multiple of 2^((b-1)*width).
+     */
+    static inline double extractor(int bin)
+    {
+        return std::ldexp(1.5, precision - 1 + (bin - 1) * width);
+    }
+
+    /**
+     * @brief The unit in which the excess of a bin over its extractor is
+     * moved to the carry during renormalization
+     */
+    static inline double carry_unit(int bin)
+    {
+        return std::ldexp(0.25, precision - 1 + (bin - 1) * width);
+    }
+
+    /**
+     * @brief The bound on the magnitude of summands deposited into an
+     * accumulator whose top bin has index `bin`
+     */
+    static inline double capacity(int bin)
+    {
+        return std::ldexp(1.0, bin * width - 1);
+    }
+
+    /**
+     * @brief Sets the lowest bit of the significand of `x`, as in ReproBLAS.
+     * The bins round the summands with this bit set, so that a summand
+     * which falls halfway between two points of the grid of a bin is
+     * rounded away from zero, whatever the contents of the bin. The bit
+     * is far below the grid of the bin, so it never changes other roundings.
+     */
+    static inline double sticky(double x)
+    {
+        return std::bit_cast<double>(std::bit_cast<std::uint64_t>(x) | 1);
+    }
+
+    /**
+     * @brief Sets the lowest bit of the significand of each lane of `x`
+     */
+    template<std::size_t W>
+    static inline pack<double, W> sticky(pack<double, W> x)
+    {
+#if defined(__GNUC__)
+        using bits = pack<std::uint64_t, W>;
+        return std::bit_cast<pack<double, W>>(std::bit_cast<bits>(x) | 1);
+#else
+        for (std::size_t k = 0; k < W; k++)
+            x[k] = sticky(x[k]);
+        return x;
+#endif
+    }
+};
+} // namespace detail
+
+/**
+ * @class
+ * class `reproducible` - template class representing a sum of floats or
+ * doubles which does not depend on the order of the summands. In particular,
+ * the parallel and the sequential accumulate() give the same bits, no matter
+ * how the range is split between threads.
+ * @param
+ * The template parameter is the raw value type: float or double.
+ *
+ * The summands are accumulated in a binned representation, after Demmel and
+ * Nguyen's pre-rounded summation (as in ReproBLAS): each summand is rounded
+ * to a fixed grid of three consecutive bins and the parts are added exactly,
+ * so the error is at most about 2^-120 times the largest summand per
+ * summand. Floats are accumulated in double-precision bins. Non-finite
+ * summands and summands of magnitude at least 2^999 are added naively into
+ * a separate term, which is not order-independent.
+ */
+template<std::floating_point V>
+requires std::same_as<V, float> || std::same_as<V, double>
+class reproducible
+{
+private:
+    using bins = detail::binning;
+    static constexpr int K = bins::folds;
+
+    int Top = bins::lowest_bin;                  // index of the top bin
+    double Capacity = bins::capacity(Top);       // bound on the summands
+    double Primary[K] = {bins::extractor(Top),   // the bins, each offset by
+                         bins::extractor(Top - 1),  // its extractor
+                         bins::extractor(Top - 2)};
+    double Carry[K] = {};                        // carries, in carry units
+    int Deposits = 0;                            // since last renormalization
+    double Special = 0;                          // out-of-range summands
+
+public:
+    // Constructors from nothing and from V:
+    reproducible() = default;
+    explicit reproducible(const V& initial_value)
+    {
+        operator+=(initial_value);
+    }
+
+//=== Conversion operators ===
+
+    /**
+     * @brief Conversion operator to the raw value type. The conversion
+     * only depends on the exact contents of the bins, and so it is
+     * reproducible as well.
+     */
+    inline operator V() const
+    {
+        value<double> total{0.0};
+        for (int j = 0; j < K; j++)
+        {   // Both parts of each bin are exact:
+            auto [high, low] = two_sum(Carry[j] * bins::carry_unit(Top - j),
+                                       Primary[j] - bins::extractor(Top - j));
+            total += high;
+            total += low;
+        }
+        return static_cast<V>(double(total) + Special);
+    }
+
+//=== Summation operators ===
+
+    /**
+     * @brief Adds in-place a raw value
+     */
+    inline void operator+= (const V& increment)
+    {
+        double x = increment;
+        if (!(std::abs(x) < Capacity))
+        {
+            if (!(std::abs(x) < bins::capacity(bins::highest_bin)))
+            {
+                Special += x;
+                return;
+            }
+            raise(x);
+        }
+        if (Deposits == bins::max_deposits)
+            renormalize();
+        deposit(x);
+        Deposits++;
+    }
+
+    /**
+     * @brief Subtracts in-place a raw value
+     */
+    inline void operator-= (const V& increment)
+    {
+        operator+=(-increment);
+    }
+
+    /**
+     * @brief Adds in-place another reproducible sum. The result does not
+     * depend on how the summands were distributed between the two objects.
+     */
+    inline void operator+= (const reproducible& other)
+    {
+        reproducible rhs = other;
+        if (rhs.Top > Top)
+            shift_to(rhs.Top);
+        else if (Top > rhs.Top)
+            rhs.shift_to(Top);
+        renormalize();
+        rhs.renormalize();
+        for (int j = 0; j < K; j++)
+        {
+            Primary[j] += rhs.Primary[j] - bins::extractor(Top - j);
+            Carry[j] += rhs.Carry[j];
+        }
+        Special += rhs.Special;
+    }
+
+    /**
+     * @brief Adds a raw value
+     */
+    inline reproducible operator+ (const V& increment) const
+    {
+        reproducible result = *this;
+        result += increment;
+        return result;
+    }
+
+    /**
+     * @brief Adds another reproducible sum
+     */
+    inline reproducible operator+ (const reproducible& other) const
+    {
+        reproducible result = *this;
+        result += other;
+        return result;
+    }
+
+    /**
+     * @brief Adds an entire collection of raw values to the present object.
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        for (auto iter = first; iter != last; ++iter)
+            operator+=(*iter);
+    }
+
+    /**
+     * @brief Adds an entire contiguous range of raw values to the present
+     * object, in blocks. The largest magnitude in a block is found first,
+     * then the block is deposited by a vectorized kernel. The result is
+     * the same as with the element-by-element accumulate().
+     * @param first - the iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename It>
+    requires is_iterator_to<It, V> && is_contiguous_iterator_to<It, V>
+    inline void accumulate(It first, It last)
+    {
+        constexpr auto block = static_cast<std::size_t>(bins::max_deposits);
+        const V* data = std::to_address(first);
+        auto count = static_cast<std::size_t>(last - first);
+        while (count > 0)
+        {
+            const std::size_t n = std::min(count, block);
+            const double* widened;
+            double buffer[std::same_as<V, double> ? 1 : block];
+            if constexpr (std::same_as<V, double>)
+                widened = data;
+            else
+            {
+                for (std::size_t i = 0; i < n; i++)
+                    buffer[i] = data[i];
+                widened = buffer;
+            }
+
+            const double max_abs = detail::max_magnitude(widened, n);
+            bool special = !(max_abs < bins::capacity(bins::highest_bin));
+            if (!special)
+            {
+                const reproducible saved = *this;
+                if (!(max_abs < Capacity))
+                    raise(max_abs);
+                deposit_block(widened, n);
+                // A NaN in the block turns the bins into NaNs
+                special = !std::isfinite(Primary[0] + Primary[K - 1]);
+                if (special)
+                    *this = saved;
+            }
+            if (special)
+            {   // Take the element-by-element path
+                for (std::size_t i = 0; i < n; i++)
+                    operator+=(data[i]);
+            }
+            data += n;
+            count -= n;
+        }
+    }
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+    /**
+     * @brief Adds an entire collection of raw values to the present object,
+     * under a standard execution policy. The result is the same for any
+     * policy and number of threads.
+     * @param policy - the execution policy
+     * @param first - the random-access iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
+     */
+    template<typename ExecutionPolicy, typename It>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+             && is_iterator_to<It, V> && std::random_access_iterator<It>
+    inline void accumulate(ExecutionPolicy&& policy, It first, It last)
+    {
+        detail::parallel_accumulate(*this, std::forward<ExecutionPolicy>(policy),
+                                    first, last);
+    }
+#endif
+
+private:
+    /**
+     * @brief Splits `x` between the bins. Each bin rounds the remaining
+     * part of `x` to its grid, breaking ties away from zero, and the rest
+     * is passed to the next bin.
+     */
+    inline void deposit(double x)
+    {
+        for (int j = 0; j < K - 1; j++)
+        {
+            double updated = Primary[j] + bins::sticky(x);
+            x -= updated - Primary[j];
+            Primary[j] = updated;
+        }
+        Primary[K - 1] += bins::sticky(x);
+    }
+
+    /**
+     * @brief Deposits a block of at most bins::max_deposits values, all of
+     * which are below the capacity, using a vectorized kernel. Every lane
+     * has its own copy of the bins, merged exactly at the end.
+     */
+    inline void deposit_block(const double* data, std::size_t count)
+    {
+        constexpr std::size_t W = detail::native_lanes<double>;
+        constexpr std::size_t U = 4;
+        using P = detail::pack<double, W>;
+
+        renormalize();
+        double extractor[K];
+        P lanes[U][K];
+        for (int j = 0; j < K; j++)
+        {
+            extractor[j] = bins::extractor(Top - j);
+            for (std::size_t u = 0; u < U; u++)
+                lanes[u][j] = detail::broadcast<double, W>(extractor[j]);
+        }
+
+        std::size_t i = 0;
+        for (; i + U*W <= count; i += U*W)
+        {
+            COMPENSATED_UNROLL
+            for (std::size_t u = 0; u < U; u++)
+            {
+                P x;
+                detail::load<double, W>(data + i + u*W, x);
+                COMPENSATED_UNROLL
+                for (int j = 0; j < K - 1; j++)
+                {
+                    P updated = lanes[u][j] + bins::sticky<W>(x);
+                    x = x - (updated - lanes[u][j]);
+                    lanes[u][j] = updated;
+                }
+                lanes[u][K - 1] += bins::sticky<W>(x);
+            }
+        }
+        for (; i < count; i++)
+            deposit(data[i]);
+
+        // Merge the lanes; all of these additions are exact
+        for (int j = 0; j < K; j++)
+            for (std::size_t u = 0; u < U; u++)
+                for (std::size_t k = 0; k < W; k++)
+                    Primary[j] += lanes[u][j][k] - extractor[j];
+        Deposits = static_cast<int>(count);
     }
 
     /**
-     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
-     * (real case with user-supplied abs() member)
+     * @brief Moves the excess of each bin over its extractor to the carry,
+     * so that further deposits remain exact
      */
-    inline void operator+= (const V& increment)
-    requires is_real<V> && has_custom_abs<V> && (!has_std_abs<V>)
+    inline void renormalize()
     {
-        V naive_sum = Sum + increment;
-        if (Sum.abs() > increment.abs()) // See comments in operator+
-            Compensation = Compensation + ((Sum - naive_sum) + increment);
-        else
-            Compensation = Compensation + ((increment - naive_sum) + Sum);
-        Sum = naive_sum;
+        for (int j = 0; j < K; j++)
+        {
+            const double unit = bins::carry_unit(Top - j);
+            const double excess = std::nearbyint((Primary[j] - bins::extractor(Top - j)) / unit);
+            Carry[j] += excess;
+            Primary[j] -= excess * unit;
+        }
+        Deposits = 0;
     }
 
-// --- Complex case
     /**
-     * @brief Add an element of type V using the Kahan-Neumaier addition
-     * (complex case)
+     * @brief Raises the top bin so that it can hold `x`. The summands
+     * deposited so far are strictly below half of the grid of the new bins,
+     * so they would have contributed nothing to them: this is why the
+     * result does not depend on the order of the summands.
      */
-    inline value<V> operator+ (const V& increment) const
-    requires is_complex<V>
+    inline void raise(double x)
     {
-        V naive_sum = Sum + increment;
-        auto inc_real = increment.real();
-        auto inc_imag = increment.imag();
+        int exponent;
+        std::frexp(x, &exponent); // |x| < 2^exponent
+        int top = (exponent + 1) / bins::width;
+        if (top * bins::width < exponent + 1)
+            top++;
+        shift_to(top);
+    }
 
-        // Real and imaginary parts of the update to Compensation:
-        decltype(inc_real) comp_update_real, comp_update_imag;
+    /**
+     * @brief Moves the bins down so that `top` becomes the top bin;
+     * bins falling off the bottom are discarded
+     */
+    inline void shift_to(int top)
+    {
+        const int shift = top - Top;
+        for (int j = K - 1; j >= 0; j--)
+        {
+            if (j >= shift)
+            {
+                Primary[j] = Primary[j - shift];
+                Carry[j] = Carry[j - shift];
+            }
+            else
+            {
+                Primary[j] = bins::extractor(top - j);
+                Carry[j] = 0;
+            }
+        }
+        Top = top;
+        Capacity = bins::capacity(Top);
+    }
+}; // class reproducible
 
-        // Compute the update to the real part of the compensation
-        if (std::abs(Sum.real()) > std::abs(inc_real))
-            comp_update_real = (Sum.real() - naive_sum.real()) + inc_real;
-        else
-            comp_update_real = (inc_real - naive_sum.real()) + Sum.real();
+//=============================================================================================
+/**
+ * @class
+ * class `superaccumulator` - an exact sum of doubles, correctly rounded on
+ * conversion to double. It has the same summation interface as
+ * `value<double>`.
+ *
+ * The sum is held as a long fixed-point integer in units of the smallest
+ * subnormal double, 2^-1074, spanning the whole exponent range of doubles.
+ * The integer is split into 32-bit digits, each stored in a 64-bit signed
+ * word (a "small superaccumulator", after Neal). Each deposit adds to three
+ * consecutive words, and the carries are propagated lazily, only once in
+ * 2^30 deposits, so the words never overflow. Two superaccumulators are
+ * merged by adding their words. Non-finite summands are added naively
+ * into a separate term.
+ */
+class superaccumulator
+{
+private:
+    // Bits per digit
+    static constexpr int digit_bits = 32;
+    // Number of digits: enough for the largest double, plus one digit for overflow
+    static constexpr int digits = 67;
+    // Offset of the exponents: the word 0 holds multiples of 2^-1074
+    static constexpr int lowest_exponent = std::numeric_limits<double>::min_exponent
+                                         - std::numeric_limits<double>::digits;
+    // Number of deposits between two carry propagations
+    static constexpr std::int64_t max_deposits = std::int64_t{1} << 30;
+    static constexpr std::int64_t digit_mask = (std::int64_t{1} << digit_bits) - 1;
 
-        // Compute the update to the imaginary part of the compensation
-        if (std::abs(Sum.imag()) > std::abs(inc_imag))
-            comp_update_imag = (Sum.imag() - naive_sum.imag()) + inc_imag;
-        else
-            comp_update_imag = (inc_imag - naive_sum.imag()) + Sum.imag();
+    std::int64_t Digit[digits] = {}; // the digits, least significant first
+    std::int64_t Deposits = 0;       // since the last carry propagation
+    double Special = 0;              // non-finite summands
 
-        return value<V>(naive_sum,
-                        Compensation + V(comp_update_real, comp_update_imag));
+public:
+    // Constructors from nothing and from double:
+    superaccumulator() = default;
+    explicit superaccumulator(double initial_value)
+    {
+        operator+=(initial_value);
     }
 
+//=== Conversion operators ===
+
     /**
-     * @brief Add in-place an element of type V using the Kahan-Neumaier addition
-     * (complex case)
+     * @brief Conversion to double, correctly rounded to nearest (ties to even)
      */
-    inline void operator+= (const V& increment)
-    requires is_complex<V>
+    inline operator double() const
     {
-        V naive_sum = Sum + increment;
-        auto inc_real = increment.real();
-        auto inc_imag = increment.imag();
-
-        // Real and imaginary parts of the update to Compensation:
-        decltype(inc_real) comp_update_real, comp_update_imag;
-
-        // Compute the update to the real part of the compensation
-        if (std::abs(Sum.real()) > std::abs(inc_real))
-            comp_update_real = (Sum.real() - naive_sum.real()) + inc_real;
-        else
-            comp_update_real = (inc_real - naive_sum.real()) + Sum.real();
+        if (Special != 0) // infinite or NaN
+            return Special;
 
-        // Compute the update to the imaginary part of the compensation
-        if (std::abs(Sum.imag()) > std::abs(inc_imag))
-            comp_update_imag = (Sum.imag() - naive_sum.imag()) + inc_imag;
-        else
-            comp_update_imag = (inc_imag - naive_sum.imag()) + Sum.imag();
-
-        // Update in-place:
-        Sum = naive_sum;
-        Compensation = Compensation + V(comp_update_real, comp_update_imag);
+        superaccumulator copy = *this;
+        copy.propagate_carries();
+        bool negative = copy.Digit[digits - 1] < 0;
+        if (negative)
+        {
+            for (auto& d : copy.Digit)
+                d = -d;
+            copy.propagate_carries();
+        }
+        double magnitude = copy.round_magnitude();
+        return negative ? -magnitude : magnitude;
     }
 
-// --- The case of V neither real nor complex - plain Kahan algorithm
+//=== Summation operators ===
+
     /**
-     * @brief Add an element of type V (neither real nor complex)
-     * using plain Kahan summation
+     * @brief Adds in-place a double, exactly
      */
-    inline value<V> operator+ (const V& increment) const
-    requires (!is_real<V>) && (!is_complex<V>)
-    {   // plain Kahan
-        V naive_sum = Sum + increment;
-        return value<V>(naive_sum,
-                        Compensation + ((Sum - naive_sum) + increment));
+    inline void operator+= (double increment)
+    {
+        if (!std::isfinite(increment))
+        {
+            Special += increment;
+            return;
+        }
+        if (Deposits == max_deposits)
+            propagate_carries();
+        deposit(increment);
+        Deposits++;
     }
 
     /**
-     * @brief Add in-place an element of type V (neither real nor complex)
-     * using plain Kahan summation
+     * @brief Subtracts in-place a double, exactly
      */
-    inline void operator+= (const V& increment)
-    requires (!is_real<V> && !is_complex<V>)
-    {   // plain Kahan
-        V naive_sum = Sum + increment;
-        Compensation = Compensation + ((Sum - naive_sum) + increment);
-        Sum = naive_sum;
+    inline void operator-= (double increment)
+    {
+        operator+=(-increment);
     }
 
-// === Operators that are common to all cases
     /**
-     * @brief Adds an element of the same type
+     * @brief Adds in-place another superaccumulator, exactly
      */
-    inline value<V> operator+ (const value<V>& other) const
-    {   // re-use previously defined operators:
-        return operator+(other.Sum) + other.Compensation;
+    inline void operator+= (const superaccumulator& other)
+    {
+        superaccumulator rhs = other;
+        rhs.propagate_carries();
+        propagate_carries();
+        for (int i = 0; i < digits; i++)
+            Digit[i] += rhs.Digit[i];
+        Deposits = 1;
+        Special += rhs.Special;
     }
 
     /**
-     * @brief Adds in-place an element of the same type
+     * @brief Subtracts in-place another superaccumulator, exactly
      */
-    inline void operator+= (const value<V>& other)
-    {   // re-use previosly defined operators:
-        operator+=(other.Sum);
-        operator+=(other.Compensation);
+    inline void operator-= (const superaccumulator& other)
+    {
+        superaccumulator rhs = other;
+        rhs.propagate_carries();
+        propagate_carries();
+        for (int i = 0; i < digits; i++)
+            Digit[i] -= rhs.Digit[i];
+        Deposits = 1;
+        Special -= rhs.Special;
     }
 
     /**
-     * @brief Adds an entire collection of raw value types to the
-     * present object. The collection is described by a pair of iterators
-     * of templated iterator type `It`. We require the iterator type `It`
-     * to behave like an iterator to V, i.e., to satisfy the concept
-     * is_iterator_to<It, V>
+     * @brief Adds an entire collection of doubles to the present object
      * @param first - the iterator to the beginning of the collection
      * @param last  - the iterator to "one-past" last element of collection
      */
     template<typename It>
-    requires is_iterator_to<It, V>
+    requires is_iterator_to<It, double>
     inline void accumulate(It first, It last)
     {
         for (auto iter = first; iter != last; ++iter)
             operator+=(*iter);
     }
-// --- Variants of operator `-`
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
     /**
-     * @brief Subtracts a raw value from the value object
+     * @brief Adds an entire collection of doubles to the present object,
+     * under a standard execution policy.
+     * @param policy - the execution policy
+     * @param first - the random-access iterator to the beginning of the collection
+     * @param last  - the iterator to "one-past" last element of collection
      */
-    inline value<V> operator- (const V& increment) const
-    requires has_unary_minus<V>
+    template<typename ExecutionPolicy, typename It>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+             && is_iterator_to<It, double> && std::random_access_iterator<It>
+    inline void accumulate(ExecutionPolicy&& policy, It first, It last)
     {
-        return operator+(-increment);
+        detail::parallel_accumulate(*this, std::forward<ExecutionPolicy>(policy),
+                                    first, last);
     }
+#endif
 
+private:
     /**
-     * @brief Subtracts a raw value from the value object
+     * @brief Adds a finite double to the digits. The double is an integer
+     * significand times a power of two, so it can be added as an integer
+     * shifted into place, spanning up to three digits.
      */
-    inline value<V> operator- (const V& increment) const
-    requires (!has_unary_minus<V>)
+    inline void deposit(double x)
     {
-        V zero = 0;
-        return operator+(zero-increment);
+        const auto bits = std::bit_cast<std::uint64_t>(x);
+        const auto biased_exponent = static_cast<int>((bits >> 52) & 0x7FF);
+        std::uint64_t significand = bits & ((std::uint64_t{1} << 52) - 1);
+        int offset = 0; // of the lowest bit, in units of 2^-1074
+        if (biased_exponent != 0)
+        {   // normal number
+            significand |= std::uint64_t{1} << 52;
+            offset = biased_exponent - 1;
+        }
+        const int index = offset / digit_bits;
+        const int shift = offset % digit_bits;
+        const auto low = static_cast<std::int64_t>((significand << shift) & digit_mask);
+        const auto rest = significand >> (digit_bits - shift);
+        const auto middle = static_cast<std::int64_t>(rest & digit_mask);
+        const auto high = static_cast<std::int64_t>(rest >> digit_bits);
+        if (bits >> 63)
+        {
+            Digit[index] -= low;
+            Digit[index + 1] -= middle;
+            Digit[index + 2] -= high;
+        }
+        else
+        {
+            Digit[index] += low;
+            Digit[index + 1] += middle;
+            Digit[index + 2] += high;
+        }
     }
 
     /**
-     * @brief Subtracts in-place a raw value from the value object
+     * @brief Brings every digit but the last one into [0, 2^32), moving
+     * the excess to the next digit. The last digit carries the sign.
      */
-    inline void operator-= (const V& increment)
-    requires has_unary_minus<V>
+    inline void propagate_carries()
     {
-        operator+=(-increment);
+        for (int i = 0; i < digits - 1; i++)
+        {
+            const std::int64_t carry = Digit[i] >> digit_bits; // floor division
+            Digit[i] &= digit_mask;
+            Digit[i + 1] += carry;
+        }
+        Deposits = 0;
     }
 
     /**
-     * @brief Subtracts in-place a raw value from the value object
+     * @brief Rounds the non-negative, carry-propagated sum to a double
      */
-    inline void operator-= (const V& increment)
-    requires (!has_unary_minus<V>)
+    inline double round_magnitude() const
     {
-        V zero = 0;
-        operator+=(zero-increment);
+        int top = digits - 1;
+        while (top >= 0 && Digit[top] == 0)
+            top--;
+        if (top < 0)
+            return 0.0;
+        if (top == digits - 1)
+            return std::numeric_limits<double>::infinity();
+
+        // Gather the 64 leading bits into `window`, and whether any bits
+        // below them are set into `sticky`:
+        auto digit = [this](int i) -> std::uint64_t
+        {
+            return i >= 0 ? static_cast<std::uint64_t>(Digit[i]) : 0;
+        };
+        const int leading = std::bit_width(digit(top)); // between 1 and 32
+        const std::uint64_t window = (digit(top) << (64 - leading))
+                                   | (digit(top - 1) << (32 - leading))
+                                   | (digit(top - 2) >> leading);
+        bool sticky = (digit(top - 2) & ((std::uint64_t{1} << leading) - 1)) != 0;
+        for (int i = top - 3; i >= 0 && !sticky; i--)
+            sticky = Digit[i] != 0;
+
+        // Round the window to 53 bits, to nearest with ties to even:
+        std::uint64_t significand = window >> 11;
+        const std::uint64_t remainder = window & 0x7FF;
+        if (remainder > 0x400 || (remainder == 0x400 && (sticky || (significand & 1))))
+            significand++;
+
+        // The leading bit of the window has weight 2^(32*top + leading - 1)
+        const int exponent = digit_bits * top + leading - 64 + 11 + lowest_exponent;
+        return std::ldexp(static_cast<double>(significand), exponent);
     }
+}; // class superaccumulator
+
+//=============================================================================================
+/**
+ * @class
+ * class `double_double` - a floating-point number represented as
+ * the unevaluated sum of two doubles, `high() + low()`, where
+ * `high()` is the sum rounded to double. It carries about 106 bits of
+ * significand, with the exponent range of double.
+ *
+ * The operations are built on the error-free transformations above, after
+ * Joldes, Muller and Popescu, "Tight and rigorous error bounds for basic
+ * building blocks of double-word arithmetic" (2017). Their relative errors
+ * are bounded by a small multiple of 2^-106. Overflows, infinities and
+ * NaNs are carried by `high()` alone.
+ */
+class double_double
+{
+private:
+    double High = 0; // the leading part, equal to the sum rounded to double
+    double Low = 0;  // the trailing part, at most half an ulp of High
+
+    // Construction from parts known to be normalized. For internal use only.
+    struct normalized_tag {};
+    constexpr double_double(double H, double L, normalized_tag) : High{H}, Low{L} {}
+
+    // Construction from the output of FastTwoSum/TwoSum:
+    explicit constexpr double_double(std::pair<double, double> parts)
+        : High{parts.first}, Low{parts.second} {}
+
+    /*
+     * Renormalizes the result `leading + trailing` of an operation, where
+     * `leading` is the result rounded to double. Non-finite results are
+     * kept in the leading part, since their trailing part is meaningless.
+     */
+    static inline double_double renormalize(double leading, double trailing)
+    {
+        if (!std::isfinite(leading))
+            return double_double(leading);
+        return double_double(fast_two_sum(leading, trailing));
+    }
+
+public:
+    // Constructors from nothing, from double, and from an unevaluated sum:
+    constexpr double_double() = default;
+    constexpr double_double(double initial_value) : High{initial_value} {}
+    constexpr double_double(double high, double low)
+        : double_double(two_sum(high, low)) {}
 
     /**
-     * @brief Subtracts another value object from the current one
+     * @brief Construction from a compensated value, keeping its compensation
+     */
+    template<algorithm A>
+    explicit double_double(const value<double, A>& compensated_value)
+        : double_double(double(compensated_value), compensated_value.error()) {}
+
+//=== Access to the parts ===
+
+    /**
+     * @brief The leading part, which is the value rounded to double
+     */
+    inline constexpr double high() const {return High;}
+
+    /**
+     * @brief The trailing part
      */
-    inline value<V> operator- (const value<V>& other) const
+    inline constexpr double low() const {return Low;}
+
+    /**
+     * @brief Conversion to double, rounded to nearest
+     */
+    explicit inline constexpr operator double() const {return High;}
+
+//=== Comparison ===
+
+    inline constexpr bool operator== (const double_double& other) const
     {
-        return operator+(-other);
+        return High == other.High && Low == other.Low;
+    }
+
+    inline constexpr std::partial_ordering operator<=> (const double_double& other) const
+    {
+        auto order = High <=> other.High;
+        return (order == 0) ? (Low <=> other.Low) : order;
     }
 
     /**
-     * @brief Subtracts in-place another value object from the current one
+     * @brief The absolute value (which also makes `double_double` a real type
+     * for the purposes of `value<double_double>`)
      */
-    inline void operator-= (const value<V>& other)
+    inline constexpr double_double abs() const
     {
-        operator+=(-other);
+        return (High < 0) ? -*this : *this;
     }
-}; // class value
 
-// ==== Left operators: V + value<V>, V - value<V>
-/**
- * @brief Operator `+` for adding a raw value on the left
- */
-template<kahanizable V>
-inline value<V> operator+(V raw, value<V> kn)
+//=== Unary minus ===
+
+    inline constexpr double_double operator- () const
+    {
+        return double_double(-High, -Low, normalized_tag{});
+    }
+
+//=== Addition and subtraction ===
+
+    /**
+     * @brief Adds a double (Algorithm 4 of Joldes et al.)
+     */
+    inline double_double operator+ (double increment) const
+    {
+        auto [sum, error] = two_sum(High, increment);
+        return renormalize(sum, Low + error);
+    }
+
+    /**
+     * @brief Adds a double_double (Algorithm 6 of Joldes et al.)
+     */
+    inline double_double operator+ (const double_double& increment) const
+    {
+        auto [high_sum, high_error] = two_sum(High, increment.High);
+        auto [low_sum, low_error] = two_sum(Low, increment.Low);
+        if (!std::isfinite(high_sum))
+            return double_double(high_sum);
+        auto [partial, partial_error] = fast_two_sum(high_sum, high_error + low_sum);
+        return double_double(fast_two_sum(partial, partial_error + low_error));
+    }
+
+    inline double_double operator- (double decrement) const
+    {
+        return operator+(-decrement);
+    }
+
+    inline double_double operator- (const double_double& decrement) const
+    {
+        return operator+(-decrement);
+    }
+
+//=== Multiplication ===
+
+    /**
+     * @brief Multiplies by a double (Algorithm 9 of Joldes et al.)
+     */
+    inline double_double operator* (double factor) const
+    {
+        auto [product, error] = two_prod(High, factor);
+        return renormalize(product, std::fma(Low, factor, error));
+    }
+
+    /**
+     * @brief Multiplies by a double_double (Algorithm 12 of Joldes et al.)
+     */
+    inline double_double operator* (const double_double& factor) const
+    {
+        auto [product, error] = two_prod(High, factor.High);
+        double cross = std::fma(High, factor.Low, Low * factor.Low);
+        cross = std::fma(Low, factor.High, cross);
+        return renormalize(product, error + cross);
+    }
+
+//=== Division ===
+
+    /**
+     * @brief Divides by a double (Algorithm 15 of Joldes et al.)
+     */
+    inline double_double operator/ (double divisor) const
+    {
+        double quotient = High / divisor;
+        if (!std::isfinite(quotient) || !std::isfinite(divisor))
+            return double_double(quotient);
+        auto [product, error] = two_prod(quotient, divisor);
+        double remainder = ((High - product) - error) + Low;
+        return double_double(fast_two_sum(quotient, remainder / divisor));
+    }
+
+    /**
+     * @brief Divides by a double_double (Algorithm 17 of Joldes et al.):
+     * multiplies by the reciprocal refined with one Newton step. The
+     * reciprocal of a subnormal divisor overflows, so such a divisor is
+     * scaled to [0.5, 1) first, and the dividend by the same power of two
+     * (which overflows only if the quotient does).
+     */
+    inline double_double operator/ (const double_double& divisor) const
+    {
+        double quotient = High / divisor.High;
+        if (!std::isfinite(quotient) || !std::isfinite(divisor.High))
+            return double_double(quotient);
+        double reciprocal = 1.0 / divisor.High;
+        if (!std::isfinite(reciprocal))
+        {
+            int exponent;
+            std::frexp(divisor.High, &exponent);
+            double_double dividend{std::pair{std::ldexp(High, -exponent),
+                                             std::ldexp(Low, -exponent)}};
+            double_double scaled{std::pair{std::ldexp(divisor.High, -exponent),
+                                           std::ldexp(divisor.Low, -exponent)}};
+            return dividend / scaled;
+        }
+        double residual = std::fma(-divisor.High, reciprocal, 1.0);
+        double_double correction{fast_two_sum(residual, -(divisor.Low * reciprocal))};
+        return operator*(correction * reciprocal + reciprocal);
+    }
+
+//=== In-place operators ===
+
+    inline void operator+= (double increment) {*this = *this + increment;}
+    inline void operator-= (double decrement) {*this = *this - decrement;}
+    inline void operator*= (double factor)    {*this = *this * factor;}
+    inline void operator/= (double divisor)   {*this = *this / divisor;}
+
+    inline void operator+= (const double_double& increment) {*this = *this + increment;}
+    inline void operator-= (const double_double& decrement) {*this = *this - decrement;}
+    inline void operator*= (const double_double& factor)    {*this = *this * factor;}
+    inline void operator/= (const double_double& divisor)   {*this = *this / divisor;}
+
+//=== Functions ===
+
+    /**
+     * @brief Square root, with one Newton step from the double square root
+     */
+    friend inline double_double sqrt(const double_double& x)
+    {
+        if (!(x.High > 0) || !std::isfinite(x.High))
+            return double_double(std::sqrt(x.High)); // zero, negative, inf or NaN
+
+        double root = std::sqrt(x.High);
+        auto [square, error] = two_prod(root, root);
+        double correction = (((x.High - square) - error) + x.Low) / (2 * root);
+        return double_double(fast_two_sum(root, correction));
+    }
+
+    friend inline constexpr double_double abs(const double_double& x)
+    {
+        return x.abs();
+    }
+}; // class double_double
+
+// ==== Left operators: double (op) double_double
+inline double_double operator+ (double x, const double_double& y)
 {
-    return kn + raw;
+    return y + x;
 }
 
-/**
- * @brief Operator `-` for subtracting from a raw value
- */
-template<kahanizable V>
-inline value<V> operator-(V raw, value<V> kn)
+inline double_double operator- (double x, const double_double& y)
 {
-    return (-kn) + raw;
+    return (-y) + x;
 }
-// ==== Left equality comparison operator: V == value<V>
+
+inline double_double operator* (double x, const double_double& y)
+{
+    return y * x;
+}
+
+inline double_double operator/ (double x, const double_double& y)
+{
+    return double_double(x) / y;
+}
+
 /**
- * @brief Operator `==` with raw value on the left
+ * @brief Output of a double_double, as the unevaluated sum of its parts
  */
-template<kahanizable V>
-requires std::equality_comparable<V>
-inline value<V> operator==(V raw, value<V> kn)
+inline std::ostream& operator<< (std::ostream& out, const double_double& x)
 {
-    return (kn == raw);
+    return out << x.high() << " + " << x.low();
 }
-// Note: operator!= will be auto-generated through C++20 "rewriting"
 
 } // namespace kn
 
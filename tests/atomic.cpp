@@ -0,0 +1,154 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <complex>
+#include <thread>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of compensated sums shared between threads
+ */
+//============================================================================================
+
+/**
+ * @test The atomic operations in a single thread
+ */
+TEST(compensated_test, atomic_value_operations)
+{
+    static_assert(compensated::atomic_value<float>::is_always_lock_free);
+    static_assert(!compensated::atomic_value<double, compensated::algorithm::klein>
+                  ::is_always_lock_free);
+
+    compensated::atomic_value<double> total{huge_dbl};
+#if defined(__x86_64__) && defined(__GNUC__)
+    // Every x86-64 processor of this century has cmpxchg16b:
+    EXPECT_TRUE(total.is_lock_free());
+#endif
+    EXPECT_EQ(double(total.fetch_add(tiny_dbl)), huge_dbl);
+    total -= huge_dbl;
+    EXPECT_EQ(double(total.load()), tiny_dbl);
+
+    compensated::value<double> partial{huge_dbl};
+    partial += tiny_dbl;
+    total += partial;
+    EXPECT_EQ(double(total.fetch_sub(huge_dbl) - huge_dbl), 2 * tiny_dbl);
+    EXPECT_EQ(double(total.exchange(compensated::value<double>{1.0})), 2 * tiny_dbl);
+    EXPECT_EQ(double(compensated::value<double>(total)), 1.0);
+
+    compensated::atomic_value<float, compensated::algorithm::klein> klein{huge_fl};
+    klein += tiny_fl;
+    klein -= huge_fl;
+    EXPECT_EQ(float(klein.load()), tiny_fl);
+}
+
+/**
+ * @test Concurrent updates are neither lost nor torn
+ */
+template<typename Atomic>
+static void concurrent_updates()
+{
+    const unsigned threads = 4, repetitions = 20000;
+    Atomic total;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back([&total]()
+        {
+            for (unsigned i = 0; i < repetitions; i++)
+            {
+                total += huge_dbl;
+                total += tiny_dbl;
+                total -= huge_dbl;
+            }
+        });
+    for (auto& worker : workers)
+        worker.join();
+    EXPECT_EQ(double(total.load()), threads * repetitions * tiny_dbl);
+}
+
+TEST(compensated_test, atomic_value_concurrent)
+{
+    concurrent_updates<compensated::atomic_value<double>>();
+    concurrent_updates<compensated::atomic_value<double, compensated::algorithm::klein>>();
+}
+
+/**
+ * @test A sharded sum in a single thread does not spill over into the shards
+ */
+TEST(compensated_test, sharded_value_operations)
+{
+    compensated::sharded_value<double> total{huge_dbl};
+    total += tiny_dbl;
+    total -= huge_dbl;
+    EXPECT_EQ(double(total.load()), tiny_dbl);
+    EXPECT_EQ(total.shards(), 0u);
+
+    compensated::value<float> partial{huge_fl};
+    partial += tiny_fl;
+    compensated::sharded_value<float> sum_fl;
+    sum_fl += partial;
+    sum_fl -= huge_fl;
+    EXPECT_EQ(float(compensated::value<float>(sum_fl)), tiny_fl);
+
+    total.clear();
+    EXPECT_EQ(double(total.load()), 0.0);
+}
+
+/**
+ * @test The shards of a contended sum are merged with compensation
+ */
+TEST(compensated_test, sharded_value_concurrent)
+{
+    concurrent_updates<compensated::sharded_value<double>>();
+    concurrent_updates<compensated::sharded_value<double, compensated::algorithm::klein>>();
+}
+
+/**
+ * @test Readers of a seqlock_value see the published values only, never a
+ * mixture of two of them
+ */
+TEST(compensated_test, seqlock_value_snapshots)
+{
+    using complex = std::complex<double>;
+    const unsigned repetitions = 100000;
+    compensated::seqlock_value<complex> total;
+    std::atomic<bool> done{false};
+    bool consistent = true;
+
+    std::thread reader([&]()
+    {
+        while (!done.load())
+        {
+            const complex snapshot{total.load()};
+            consistent = consistent && snapshot.real() == snapshot.imag();
+        }
+    });
+    for (unsigned i = 0; i < repetitions; i++)
+    {
+        total += complex{huge_dbl, huge_dbl};
+        total += complex{tiny_dbl, tiny_dbl};
+        total -= complex{huge_dbl, huge_dbl};
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(complex(total.load()), double(repetitions) * complex(tiny_dbl, tiny_dbl));
+
+    std::vector<double> tiny(1000, tiny_dbl);
+    compensated::seqlock_value<double> sum_dbl{huge_dbl};
+    sum_dbl.accumulate(tiny.begin(), tiny.end());
+    sum_dbl -= huge_dbl;
+    EXPECT_EQ(double(compensated::value<double>(sum_dbl)), 1000 * tiny_dbl);
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
@@ -7,6 +7,8 @@
  *
  */
 
+#include <cstdint>
+
 #include "tests.h"
 #include "lossy_values.h"
 #include "../compensated.h"
@@ -78,6 +80,40 @@ TEST(compensated_test, conversions)
     EXPECT_DOUBLE_EQ(imkz, z.imag());
 }
 
+/**
+ * @test Check that raw values of other types, convertible to the raw value
+ * type, can be used on both sides of the operators
+ */
+TEST(compensated_test, heterogeneous_operators)
+{
+    compensated::value<double> k{huge_dbl};
+    k += 1;                  // int
+    k += std::int64_t{-1};
+    k += tiny_fl;            // float
+    k -= huge_dbl;
+    EXPECT_EQ(double(k), double(tiny_fl));
+
+    compensated::value<double> left = 1 + k;
+    EXPECT_EQ(double(left), 1.0 + double(tiny_fl));
+    left = 2.0f - left;
+    EXPECT_EQ(double(left), 1.0 - double(tiny_fl));
+    EXPECT_TRUE(0 == compensated::value<double>{0.0});
+
+    // A compensated float, with its compensation, added to a compensated double
+    compensated::value<float> kf{huge_fl};
+    kf += tiny_fl;
+    compensated::value<double> kd{-double(huge_fl)};
+    kd += kf;
+    EXPECT_EQ(double(kd), double(tiny_fl));
+
+    // A compensated double added to a compensated float: the part of the
+    // double lost in rounding it to a float goes to the compensation
+    compensated::value<double> wide{1.0 + tiny_dbl};
+    compensated::value<float> narrow{-1.0f};
+    narrow += wide;
+    EXPECT_EQ(float(narrow), float(tiny_dbl));
+}
+
 /**
  * @test Check if the equality comparison operators work as expected
  */
@@ -223,4 +259,78 @@ TEST(compensated_test, kahan_neumaier_complex)
     EXPECT_DOUBLE_EQ(sum.imag(), 0.0);
 }
 
+/**
+ * @test Test that the branch-free TwoSum algorithm gives exactly the
+ * same results as the Kahan-Neumaier algorithm
+ */
+TEST(compensated_test, two_sum_algorithm)
+{
+    using compensated::algorithm;
+    const double inputs[] = {huge_dbl, tiny_dbl, -3.5, -huge_dbl, 1.0e-3,
+                             tiny_dbl * tiny_dbl, -7.25e10, huge_dbl * 1.5};
+    compensated::value<double, algorithm::neumaier> kn{0.0};
+    compensated::value<double, algorithm::two_sum> ts{0.0};
+    for (double x : inputs)
+    {
+        kn += x;
+        ts = ts + x;
+        EXPECT_EQ(double(kn), double(ts));
+        EXPECT_EQ(kn.error(), ts.error());
+    }
+
+    // Complex values: TwoSum acts on each component
+    std::complex<double> z{huge_dbl, tiny_dbl};
+    std::complex<double> w{tiny_dbl, huge_dbl};
+    compensated::value<std::complex<double>, algorithm::two_sum> kz{z};
+    kz += w;
+    kz -= z;
+    kz = kz - w;
+    EXPECT_DOUBLE_EQ(kz.real(), 0.0);
+    EXPECT_DOUBLE_EQ(kz.imag(), 0.0);
+}
+
+/**
+ * @test Test the explicit choice of summation algorithm
+ */
+TEST(compensated_test, algorithm_choice)
+{
+    using compensated::algorithm;
+    using compensated::value;
+
+    // The default algorithm is chosen from the raw value type
+    static_assert(value<double>::method == algorithm::neumaier);
+    static_assert(std::is_same_v<value<double>, value<double, algorithm::neumaier>>);
+    EXPECT_EQ(sizeof(value<double, algorithm::klein>), 3*sizeof(double));
+
+    // The naive algorithm loses precision; the others do not
+    value<double, algorithm::naive> naive{huge_dbl};
+    value<double, algorithm::kahan> kahan{huge_dbl};
+    value<double, algorithm::klein> klein{huge_dbl};
+    naive += tiny_dbl;
+    kahan += tiny_dbl;
+    klein += tiny_dbl;
+    naive -= huge_dbl;
+    kahan -= huge_dbl;
+    klein -= huge_dbl;
+    EXPECT_EQ(double(naive), 0.0);
+    EXPECT_DOUBLE_EQ(double(kahan), tiny_dbl);
+    EXPECT_DOUBLE_EQ(double(klein), tiny_dbl);
+
+    /* Klein's second-order algorithm retains a tiny error term which
+     * is lost by Kahan-Neumaier when it is added to a much larger one.
+     */
+    const double tinier = tiny_dbl * tiny_dbl;
+    const double huger = huge_dbl * huge_dbl * huge_dbl;
+    const double inputs[] = {1.0, tinier, huger, -huger, -1.0};
+    value<double> kn{0.0};
+    klein = 0.0;
+    for (double x : inputs)
+    {
+        kn += x;
+        klein += x;
+    }
+    EXPECT_EQ(double(kn), 0.0);
+    EXPECT_EQ(double(klein), tinier);
+}
+
 // vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
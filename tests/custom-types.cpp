@@ -46,6 +46,22 @@ TEST(compensated_test, custom_real_type)
     EXPECT_TRUE(result.is_zero());
 }
 
+/**
+ * @test Test the branch-free TwoSum algorithm with a custom value
+ * type representing a real number
+ */
+TEST(compensated_test, custom_real_type_two_sum)
+{
+    real_with_custom_abs h = huge_dbl;
+    real_with_custom_abs t = tiny_dbl;
+    compensated::value<real_with_custom_abs, compensated::algorithm::two_sum> kx{h};
+    kx += t;
+    kx -= h;
+    kx = kx - t;
+    real_with_custom_abs result = kx;
+    EXPECT_TRUE(result.is_zero());
+}
+
 /**
  * @test Test the Kahan-Neumaier summation with a custom complex-like type
  */
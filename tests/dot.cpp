@@ -0,0 +1,94 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <complex>
+#include <list>
+#include <vector>
+
+#include "tests.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of compensated dot products
+ */
+//============================================================================================
+
+/**
+ * @brief Fills the vectors with `count` triples of factors whose products
+ * are p, tiny and -p, where p is not representable in the working precision.
+ * The exact dot product is then `count` times `tiny`.
+ */
+template<typename T>
+static void ill_conditioned(std::vector<T>& x, std::vector<T>& y, unsigned count,
+                            T epsilon, T tiny)
+{
+    x.clear();
+    y.clear();
+    for (unsigned i = 0; i < count; i++)
+    {
+        x.insert(x.end(), {T(1) + epsilon, tiny, -(T(1) + epsilon)});
+        y.insert(y.end(), {T(1) - epsilon, T(1), T(1) - epsilon});
+    }
+}
+
+/**
+ * @test The dot products of doubles and floats keep the rounding errors
+ * of the products, for all lengths of the vectorized kernel's tail
+ */
+TEST(compensated_test, dot_real)
+{
+    std::vector<double> x, y;
+    for (unsigned count = 0; count < 40; count++)
+    {
+        ill_conditioned(x, y, count, 0x1p-30, 0x1p-70);
+        EXPECT_EQ(double(compensated::dot(x, y)), count * 0x1p-70);
+
+        // The generic path gives the same result
+        std::list<double> list_x(x.begin(), x.end());
+        EXPECT_EQ(double(compensated::dot(list_x.begin(), list_x.end(), y.begin())),
+                  count * 0x1p-70);
+    }
+
+    std::vector<float> fx, fy;
+    ill_conditioned(fx, fy, 100, 0x1p-13f, 0x1p-40f);
+    EXPECT_EQ(float(compensated::dot(fx, fy)), 100 * 0x1p-40f);
+
+    // Other algorithms
+    compensated::value<double, compensated::algorithm::klein> klein;
+    ill_conditioned(x, y, 10, 0x1p-30, 0x1p-70);
+    klein.accumulate_products(x.begin(), x.end(), y.begin());
+    EXPECT_EQ(double(klein), 10 * 0x1p-70);
+}
+
+/**
+ * @test The dot products of complex numbers keep the rounding errors
+ * of the products of their parts
+ */
+TEST(compensated_test, dot_complex)
+{
+    using complex = std::complex<double>;
+    const complex z{1 + 0x1p-30, -1 - 0x1p-31}, w{1 - 0x1p-30, 1 + 0x1p-29};
+    const complex tiny{0x1p-70, -0x1p-72};
+    for (unsigned count = 0; count < 20; count++)
+    {
+        std::vector<complex> x, y;
+        for (unsigned i = 0; i < count; i++)
+        {
+            x.insert(x.end(), {z, tiny, -z});
+            y.insert(y.end(), {w, complex(1), w});
+        }
+        const complex expected = double(count) * tiny;
+        EXPECT_EQ(complex(compensated::dot(x, y)), expected);
+
+        std::list<complex> list_x(x.begin(), x.end());
+        EXPECT_EQ(complex(compensated::dot(list_x, y)), expected);
+    }
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
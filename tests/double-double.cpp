@@ -0,0 +1,135 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "tests.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of the error-free transformations and double-double arithmetic
+ */
+//============================================================================================
+
+using compensated::double_double;
+
+/**
+ * @brief The relative distance between a double_double and an exact value
+ * given as the unevaluated sum `high + low`
+ */
+static double relative_error(const double_double& x, double high, double low)
+{
+    double_double difference = (x - high) - low;
+    return std::abs(difference.high() / high);
+}
+
+/**
+ * @test The error-free transformations are exact
+ */
+TEST(compensated_test, error_free_transformations)
+{
+    auto [product, error] = compensated::two_prod(1.0 + 0x1p-30, 1.0 - 0x1p-30);
+    EXPECT_EQ(product, 1.0);
+    EXPECT_EQ(error, -0x1p-60);
+
+    auto [sum, sum_error] = compensated::fast_two_sum(1.0, 0x1p-60);
+    EXPECT_EQ(sum, 1.0);
+    EXPECT_EQ(sum_error, 0x1p-60);
+
+    auto [float_product, float_error] = compensated::two_prod(1.0f + 0x1p-20f, 1.0f + 0x1p-20f);
+    EXPECT_EQ(float_product, 1.0f + 0x1p-19f);
+    EXPECT_EQ(float_error, 0x1p-40f);
+}
+
+/**
+ * @test Arithmetic operations keep about 106 bits
+ */
+TEST(compensated_test, double_double_arithmetic)
+{
+    constexpr double bound = 0x1p-100;
+
+    double_double one_and_bit = double_double(1.0) + 0x1p-80;
+    EXPECT_EQ(one_and_bit.high(), 1.0);
+    EXPECT_EQ(one_and_bit.low(), 0x1p-80);
+    EXPECT_EQ((one_and_bit - 1.0).high(), 0x1p-80);
+    EXPECT_EQ((one_and_bit * one_and_bit - 1.0).high(), 0x1p-79);
+
+    // (1 + 2^-40)(1 - 2^-40) = 1 - 2^-80, exactly
+    double_double a{1.0 + 0x1p-40}, b{1.0 - 0x1p-40};
+    EXPECT_EQ(a * b, double_double(1.0, -0x1p-80));
+    EXPECT_EQ((a * (1.0 - 0x1p-40)), double_double(1.0, -0x1p-80));
+
+    // 1/3, checked by multiplying back
+    double_double third = double_double(1.0) / 3.0;
+    EXPECT_LT(relative_error(third * 3.0, 1.0, 0.0), bound);
+    double_double seventh = double_double(1.0) / double_double(7.0);
+    EXPECT_LT(relative_error(seventh * double_double(7.0), 1.0, 0.0), bound);
+    EXPECT_LT(relative_error(third / seventh, 7.0 / 3.0,
+                             std::fma(-7.0 / 3.0, 3.0, 7.0) / 3.0), bound);
+
+    // sqrt(2)^2 == 2
+    double_double root = sqrt(double_double(2.0));
+    EXPECT_LT(relative_error(root * root, 2.0, 0.0), bound);
+    EXPECT_EQ(root.high(), std::sqrt(2.0));
+    EXPECT_EQ(sqrt(double_double(0.0)).high(), 0.0);
+    EXPECT_TRUE(std::isnan(sqrt(double_double(-1.0)).high()));
+
+    // Comparisons look at the trailing parts
+    EXPECT_LT(double_double(1.0), one_and_bit);
+    EXPECT_GT(-double_double(1.0), -one_and_bit);
+    EXPECT_EQ(abs(-one_and_bit), one_and_bit);
+    EXPECT_EQ(double(2.0 - one_and_bit), 1.0);
+
+    // Infinities are carried by the leading part
+    double_double infinite = double_double(std::numeric_limits<double>::max()) * 2.0;
+    EXPECT_TRUE(std::isinf(double(infinite)));
+}
+
+/**
+ * @test Division by a subnormal divisor, whose reciprocal overflows,
+ * gives a finite quotient
+ */
+TEST(compensated_test, double_double_subnormal_divisor)
+{
+    constexpr double bound = 0x1p-100;
+
+    double_double quotient = double_double(1e-300) / double_double(1e-310);
+    EXPECT_TRUE(std::isfinite(quotient.high()));
+    EXPECT_LT(relative_error(quotient * double_double(1e-310), 1e-300, 0.0), 0x1p-50);
+    EXPECT_EQ(quotient.high(), 1e-300 / 1e-310);
+
+    // The quotient of exact values is exact
+    const double tiny = 0x1p-1060;
+    double_double exact = double_double(3.0 * 0x1p-1000) / double_double(tiny);
+    EXPECT_EQ(exact, double_double(3.0 * 0x1p60));
+    double_double third = double_double(tiny) / double_double(3.0 * tiny);
+    EXPECT_LT(relative_error(third * 3.0, 1.0, 0.0), bound);
+    EXPECT_EQ(double_double(-0x1p-60) / double_double(tiny), double_double(-0x1p1000));
+}
+
+/**
+ * @test Double-double interoperates with compensated values
+ */
+TEST(compensated_test, double_double_with_value)
+{
+    compensated::value<double> v{1.0};
+    v += 0x1p-70;
+    double_double from_value{v};
+    EXPECT_EQ(from_value, double_double(1.0, 0x1p-70));
+
+    // A compensated sum of double-doubles
+    compensated::value<double_double> sum;
+    sum += double_double(1.0, 0x1p-60);
+    sum += double_double(0x1p-120);
+    sum -= double_double(1.0, 0x1p-60);
+    EXPECT_EQ(double_double(sum), double_double(0x1p-120));
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
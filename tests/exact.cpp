@@ -0,0 +1,116 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "tests.h"
+#include "random_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of exact summation
+ */
+//============================================================================================
+
+/**
+ * @test The exact sum is correctly rounded where compensated sums are not
+ */
+TEST(compensated_test, superaccumulator_rounding)
+{
+    // The tie 1 + 2^-53 is broken by a summand far below the compensation
+    std::vector<double> tie = {1.0, 0x1p-53, 0x1p-150};
+    compensated::superaccumulator exact;
+    exact.accumulate(tie.begin(), tie.end());
+    EXPECT_EQ(double(exact), 1.0 + 0x1p-52);
+
+    std::vector<double> cancelling = {1e308, 1e308, -1e308, -1e308, 1e-300};
+    compensated::superaccumulator tiny;
+    tiny.accumulate(cancelling.begin(), cancelling.end());
+    EXPECT_EQ(double(tiny), 1e-300);
+
+    // Ties to even, of both signs
+    compensated::superaccumulator even{-1.0};
+    even -= 0x1p-53;
+    EXPECT_EQ(double(even), -1.0);
+    even -= 0x1p-52;
+    EXPECT_EQ(double(even), -1.0 - 0x1p-51);
+
+    // Subnormal results are exact
+    const double denorm = std::numeric_limits<double>::denorm_min();
+    compensated::superaccumulator subnormal{std::numeric_limits<double>::min()};
+    subnormal += 3 * denorm;
+    subnormal -= std::numeric_limits<double>::min();
+    EXPECT_EQ(double(subnormal), 3 * denorm);
+    EXPECT_EQ(double(compensated::superaccumulator{}), 0.0);
+}
+
+/**
+ * @test The exact sum does not depend on the order of summands, and the
+ * residual of its rounding is at most half an ulp
+ */
+TEST(compensated_test, superaccumulator_exactness)
+{
+    std::vector<double> v = random_values(20000, -1070, 1020);
+    compensated::superaccumulator forward;
+    for (double x : v)
+        forward += x;
+
+    std::shuffle(v.begin(), v.end(), std::mt19937_64(42));
+    compensated::superaccumulator shuffled, first_part, second_part;
+    shuffled.accumulate(v.begin(), v.end());
+    first_part.accumulate(v.begin(), v.begin() + 777);
+    second_part.accumulate(v.begin() + 777, v.end());
+    first_part += second_part;
+
+    const double sum = forward;
+    EXPECT_EQ(double(shuffled), sum);
+    EXPECT_EQ(double(first_part), sum);
+
+    forward -= sum;
+    const double residual = forward;
+    EXPECT_LE(2 * std::abs(residual), std::abs(std::nextafter(sum, 2 * sum) - sum));
+}
+
+/**
+ * @test Overflow and non-finite summands
+ */
+TEST(compensated_test, superaccumulator_non_finite)
+{
+    const double max = std::numeric_limits<double>::max();
+    compensated::superaccumulator big{max};
+    big += max;
+    EXPECT_EQ(double(big), std::numeric_limits<double>::infinity());
+    big -= max;
+    EXPECT_EQ(double(big), max); // intermediate overflow is harmless
+
+    big -= std::numeric_limits<double>::infinity();
+    EXPECT_EQ(double(big), -std::numeric_limits<double>::infinity());
+    big += std::numeric_limits<double>::infinity();
+    EXPECT_TRUE(std::isnan(double(big)));
+}
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @test The parallel accumulate() gives the same result as the sequential one
+ */
+TEST(compensated_test, superaccumulator_parallel)
+{
+    std::vector<double> v = random_values(300000, -1070, 1020);
+    compensated::superaccumulator sequential, parallel;
+    sequential.accumulate(v.begin(), v.end());
+    parallel.accumulate(std::execution::par_unseq, v.begin(), v.end());
+    EXPECT_EQ(double(sequential), double(parallel));
+}
+#endif
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
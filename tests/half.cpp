@@ -0,0 +1,138 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "tests.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of sums of 16-bit floating-point values
+ */
+//============================================================================================
+
+#if defined(__FLT16_MAX__)
+/**
+ * @test Sums of _Float16 use the Kahan-Neumaier algorithm, although std::abs
+ * does not support the type
+ */
+TEST(compensated_test, half_value)
+{
+    static_assert(compensated::is_half_precision<_Float16>);
+    static_assert(compensated::default_algorithm<_Float16> == compensated::algorithm::neumaier);
+
+    const _Float16 huge = 2048, one = 1;
+    compensated::value<_Float16> sum{huge};
+    for (unsigned i = 0; i < 3; i++)
+        sum += one; // Each increment is lost to rounding in a plain sum
+    sum -= huge;
+    EXPECT_EQ(float(_Float16(sum)), 3.0f);
+
+    compensated::value<_Float16> reversed{one};
+    reversed += huge; // The increment is larger than the sum
+    reversed -= huge;
+    EXPECT_EQ(float(_Float16(reversed)), 1.0f);
+}
+
+/**
+ * @test Contiguous ranges of _Float16 are added to sums of floats and
+ * doubles by the converting kernel, for lengths which exercise both the
+ * vector loop and the tail
+ */
+TEST(compensated_test, half_accumulate_contiguous)
+{
+    for (unsigned length = 0; length < 150; length++)
+    {
+        std::vector<_Float16> halves;
+        double expected = 0;
+        for (unsigned i = 0; i < length; i++)
+        {
+            halves.push_back(_Float16(0.125f * float(i % 13) - 0.75f));
+            expected += double(halves.back()); // exact: the values are multiples of 1/8
+        }
+
+        compensated::value<float> to_float;
+        to_float.accumulate(halves);
+        EXPECT_EQ(float(to_float), float(expected));
+
+        compensated::value<double> to_double;
+        to_double.accumulate(halves.begin(), halves.end());
+        EXPECT_EQ(double(to_double), expected);
+    }
+}
+
+/**
+ * @test Every finite _Float16 value, including the subnormal ones, is
+ * converted exactly; infinities and NaNs are not lost
+ */
+TEST(compensated_test, half_accumulate_all_values)
+{
+    std::vector<_Float16> positive;
+    compensated::value<double, compensated::algorithm::klein> expected;
+    for (std::uint32_t bits = 0; bits < 0x7c00; bits++)
+    {
+        std::uint16_t pattern = static_cast<std::uint16_t>(bits);
+        _Float16 h;
+        std::memcpy(&h, &pattern, sizeof(h));
+        positive.push_back(h);
+        expected += double(h);
+    }
+    compensated::value<double> sum;
+    sum.accumulate(positive);
+    EXPECT_DOUBLE_EQ(double(sum), double(expected));
+
+    // The negative values cancel the positive ones
+    std::vector<_Float16> symmetric = positive;
+    for (_Float16 h : positive)
+        symmetric.push_back(-h);
+    compensated::value<float> zero;
+    zero.accumulate(symmetric);
+    EXPECT_EQ(float(zero), 0.0f);
+
+    std::vector<_Float16> with_inf(100, _Float16(1.0f));
+    with_inf[37] = std::numeric_limits<float>::infinity();
+    compensated::value<float> inf;
+    inf.accumulate(with_inf);
+    EXPECT_FALSE(std::isfinite(float(inf))); // The compensation of an infinity is NaN
+
+    std::vector<_Float16> with_nan(100, _Float16(1.0f));
+    with_nan[70] = std::numeric_limits<float>::quiet_NaN();
+    compensated::value<double> nan;
+    nan.accumulate(with_nan);
+    EXPECT_TRUE(std::isnan(double(nan)));
+}
+
+/**
+ * @test Sums of _Float16 values accumulated in floats do not stagnate
+ */
+TEST(compensated_test, half_widened)
+{
+    std::vector<_Float16> eighths(10000, _Float16(0.125f));
+    _Float16 naive = 0;
+    for (_Float16 h : eighths)
+        naive += h;
+    EXPECT_EQ(float(naive), 256.0f); // Adding 1/8 to 256 has no effect in _Float16
+
+    compensated::widened_value<_Float16> widened;
+    widened.accumulate(eighths);
+    EXPECT_EQ(float(widened.wide()), 1250.0f);
+    EXPECT_EQ(float(_Float16(widened)), 1250.0f);
+
+    compensated::widened_value<_Float16, compensated::algorithm::neumaier> compensated;
+    compensated.accumulate(eighths.begin(), eighths.end());
+    compensated += _Float16(0.5f);
+    EXPECT_EQ(float(compensated.wide()), 1250.5f);
+}
+#endif
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
@@ -0,0 +1,108 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <list>
+#include <random>
+#include <vector>
+
+#include "tests.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of streaming statistics
+ */
+//============================================================================================
+
+/**
+ * @brief Checks the statistics of the sequence 2, 4, 4, 4, 5, 5, 7, 9 shifted by `offset`
+ */
+static void expect_textbook_statistics(const compensated::moments<double>& m, double offset)
+{
+    EXPECT_EQ(m.count(), 8u);
+    EXPECT_DOUBLE_EQ(m.mean(), offset + 5);
+    EXPECT_DOUBLE_EQ(m.variance(), 4);
+    EXPECT_DOUBLE_EQ(m.sample_variance(), 32.0 / 7);
+    EXPECT_DOUBLE_EQ(m.standard_deviation(), 2);
+    EXPECT_DOUBLE_EQ(m.skewness(), 21.0 / 32);
+    EXPECT_DOUBLE_EQ(m.kurtosis(), 2.78125);
+    EXPECT_DOUBLE_EQ(m.excess_kurtosis(), -0.21875);
+    EXPECT_EQ(m.min(), offset + 2);
+    EXPECT_EQ(m.max(), offset + 9);
+}
+
+/**
+ * @test Statistics of a short sequence, far from and close to zero,
+ * added one by one, as a contiguous block and merged from parts
+ */
+TEST(compensated_test, moments_textbook)
+{
+    for (double offset : {0.0, 1e9, -1e12})
+    {
+        std::vector<double> v = {2, 4, 4, 4, 5, 5, 7, 9};
+        for (auto& x : v)
+            x += offset;
+
+        compensated::moments<double> single, block, first, second;
+        for (double x : v)
+            single += x;
+        expect_textbook_statistics(single, offset);
+
+        block.accumulate(v.begin(), v.end());
+        expect_textbook_statistics(block, offset);
+
+        std::list<double> list(v.begin(), v.begin() + 3);
+        first.accumulate(list.begin(), list.end());
+        second.accumulate(v.begin() + 3, v.end());
+        first += second;
+        expect_textbook_statistics(first, offset);
+    }
+
+    compensated::moments<float> empty;
+    EXPECT_EQ(empty.count(), 0u);
+    EXPECT_EQ(empty.max(), -std::numeric_limits<float>::infinity());
+}
+
+/**
+ * @test The vectorized, sequential and parallel paths agree on long streams
+ */
+TEST(compensated_test, moments_long_stream)
+{
+    std::mt19937_64 generator(2021);
+    std::gamma_distribution<double> skewed(2.0, 3.0);
+    std::vector<double> v(200000);
+    for (auto& x : v)
+        x = 1e6 + skewed(generator);
+
+    compensated::moments<double> single, block;
+    for (double x : v)
+        single += x;
+    block.accumulate(v.begin(), v.end());
+    EXPECT_EQ(block.count(), v.size());
+    EXPECT_NEAR(block.mean(), single.mean(), 1e-15 * single.mean());
+    EXPECT_NEAR(block.variance(), single.variance(), 1e-12 * single.variance());
+    EXPECT_NEAR(block.skewness(), single.skewness(), 1e-10);
+    EXPECT_NEAR(block.kurtosis(), single.kurtosis(), 1e-10);
+    EXPECT_EQ(block.min(), single.min());
+    EXPECT_EQ(block.max(), single.max());
+
+    // Gamma(2, 3): variance 18, skewness 2/sqrt(2), excess kurtosis 3
+    EXPECT_NEAR(block.variance(), 18, 0.5);
+    EXPECT_NEAR(block.skewness(), std::sqrt(2.0), 0.1);
+    EXPECT_NEAR(block.excess_kurtosis(), 3, 0.5);
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+    compensated::moments<double> parallel;
+    parallel.accumulate(std::execution::par_unseq, v.begin(), v.end());
+    EXPECT_NEAR(parallel.mean(), single.mean(), 1e-15 * single.mean());
+    EXPECT_NEAR(parallel.variance(), single.variance(), 1e-12 * single.variance());
+    EXPECT_NEAR(parallel.kurtosis(), single.kurtosis(), 1e-10);
+#endif
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
@@ -0,0 +1,160 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <cmath>
+#include <concepts>
+#include <list>
+#include <vector>
+
+#include "tests.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of compensated polynomial evaluation
+ */
+//============================================================================================
+
+/**
+ * @brief Reference Clenshaw evaluation in double-double arithmetic
+ */
+static double clenshaw_reference(const std::vector<double>& c, double x)
+{
+    using compensated::double_double;
+    double_double b1, b2;
+    for (std::size_t k = c.size() - 1; k > 0; k--)
+    {
+        double_double b = b1 * (2 * x) - b2 + c[k];
+        b2 = b1;
+        b1 = b;
+    }
+    return double(b1 * x - b2 + c[0]);
+}
+
+/**
+ * @test Compensated Horner evaluation of (x - 1)^6 close to its root,
+ * where plain Horner evaluation returns noise
+ */
+TEST(compensated_test, horner_near_root)
+{
+    const std::vector<double> coefficients = {1, -6, 15, -20, 15, -6, 1};
+    for (int k = -40; k <= 40; k++)
+    {
+        if (k == 0)
+            continue;
+        const double x = 1 + k * 0x1p-14;
+        const double exact = std::pow(k * 0x1p-14, 6); // exact for these k
+        const double computed = compensated::horner(coefficients.begin(),
+                                                    coefficients.end(), x);
+        EXPECT_NEAR(computed, exact, 1e-4 * exact);
+    }
+    EXPECT_EQ(double(compensated::horner(coefficients.begin(), coefficients.end(), 1.0)), 0);
+    EXPECT_EQ(double(compensated::horner(coefficients.end(), coefficients.end(), 2.0)), 0);
+}
+
+/**
+ * @test The type of the result is that of the coefficients, whatever the
+ * type of the point: a float or an int point is converted to double
+ * without rounding the coefficients to its type
+ */
+TEST(compensated_test, polynomial_point_types)
+{
+    const std::vector<double> coefficients = {0.1, 0.2 / 3, 0.3 / 7};
+    const auto at_float = compensated::horner(coefficients.begin(), coefficients.end(), 2.0f);
+    const auto at_int = compensated::horner(coefficients.begin(), coefficients.end(), 2);
+    static_assert(std::same_as<decltype(at_float), const compensated::value<double>>);
+    static_assert(std::same_as<decltype(at_int), const compensated::value<double>>);
+    const double expected = double(compensated::horner(coefficients.begin(),
+                                                       coefficients.end(), 2.0));
+    EXPECT_EQ(double(at_float), expected);
+    EXPECT_EQ(double(at_int), expected);
+
+    const auto series_at_float = compensated::clenshaw(coefficients.begin(), coefficients.end(), 0.5f);
+    const auto series_at_int = compensated::clenshaw(coefficients.begin(), coefficients.end(), 1);
+    static_assert(std::same_as<decltype(series_at_float), const compensated::value<double>>);
+    static_assert(std::same_as<decltype(series_at_int), const compensated::value<double>>);
+    EXPECT_EQ(double(series_at_float), clenshaw_reference(coefficients, 0.5));
+    EXPECT_EQ(double(series_at_int), clenshaw_reference(coefficients, 1.0));
+
+    // Float coefficients at a double point are evaluated in float
+    const std::vector<float> narrow = {0.5f, 0.25f};
+    const auto narrow_at_double = compensated::horner(narrow.begin(), narrow.end(), 2.0);
+    static_assert(std::same_as<decltype(narrow_at_double), const compensated::value<float>>);
+    EXPECT_EQ(float(narrow_at_double), 1.0f);
+}
+
+/**
+ * @test Compensated Clenshaw evaluation of a Chebyshev series close to
+ * its root, compared with double-double evaluation
+ */
+TEST(compensated_test, clenshaw_near_root)
+{
+    std::vector<double> coefficients = {0, 0.5, -0.25, 0.125, 1.0 / 3, -0.1, 0.7, 0.05};
+    const double root = 0.3;
+    coefficients[0] = -clenshaw_reference(coefficients, root);
+    for (int k = -40; k <= 40; k++)
+    {
+        const double x = root + k * 0x1p-40;
+        const double reference = clenshaw_reference(coefficients, x);
+        const double computed = compensated::clenshaw(coefficients.begin(),
+                                                      coefficients.end(), x);
+        EXPECT_NEAR(computed, reference, 1e-10 * std::abs(reference) + 0x1p-100);
+    }
+    // Short series
+    EXPECT_EQ(double(compensated::clenshaw(coefficients.begin(), coefficients.begin(), 0.5)), 0);
+    EXPECT_EQ(double(compensated::clenshaw(coefficients.begin() + 1,
+                                           coefficients.begin() + 2, 0.5)), 0.5);
+    EXPECT_EQ(double(compensated::clenshaw(coefficients.begin() + 1,
+                                           coefficients.begin() + 3, 0.5)), 0.375);
+}
+
+/**
+ * @test The batched evaluation, vectorized or not, agrees with the
+ * evaluation at single points, for all lengths of the last block
+ */
+TEST(compensated_test, polynomial_batched)
+{
+    const std::vector<double> coefficients = {1, -6, 15, -20, 15, -6, 1};
+    for (unsigned count = 0; count < 40; count++)
+    {
+        std::vector<double> points;
+        for (unsigned i = 0; i < count; i++)
+            points.push_back(1 + (double(i) - 20) * 0x1p-12);
+        std::list<double> point_list(points.begin(), points.end());
+
+        std::vector<double> horner(count), horner_list(count);
+        std::vector<double> clenshaw(count), clenshaw_list(count);
+        auto end = compensated::horner(coefficients.begin(), coefficients.end(),
+                                       points.begin(), points.end(), horner.begin());
+        EXPECT_EQ(end, horner.end());
+        compensated::horner(coefficients.begin(), coefficients.end(),
+                            point_list.begin(), point_list.end(), horner_list.begin());
+        compensated::clenshaw(coefficients.begin(), coefficients.end(),
+                              points.begin(), points.end(), clenshaw.begin());
+        compensated::clenshaw(coefficients.begin(), coefficients.end(),
+                              point_list.begin(), point_list.end(), clenshaw_list.begin());
+        for (unsigned i = 0; i < count; i++)
+        {
+            EXPECT_DOUBLE_EQ(horner[i], horner_list[i]);
+            EXPECT_DOUBLE_EQ(clenshaw[i], clenshaw_list[i]);
+            EXPECT_DOUBLE_EQ(horner[i], double(compensated::horner(
+                             coefficients.begin(), coefficients.end(), points[i])));
+        }
+    }
+
+    // Floats, into a back inserter
+    const std::vector<float> float_coefficients = {1, -3, 3, -1};
+    const std::vector<float> float_points = {0.5f, 1.0f, 1.5f, 2.0f, 3.0f};
+    std::vector<float> values;
+    compensated::horner(float_coefficients.begin(), float_coefficients.end(),
+                        float_points.begin(), float_points.end(),
+                        std::back_inserter(values));
+    EXPECT_EQ(values, (std::vector<float>{0.125f, 0.0f, -0.125f, -1.0f, -8.0f}));
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
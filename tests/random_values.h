@@ -0,0 +1,40 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+#ifndef __RANDOM_VALUES_H__
+#define __RANDOM_VALUES_H__
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/**
+ * @file This file declares a utility function which produces reproducible
+ * pseudo-random doubles of both signs, spanning many orders of magnitude.
+ */
+
+/**
+ * @brief random_values() returns `count` doubles of the form m * 2^e, with
+ * the mantissa m uniform in [-1, 1) and the exponent e uniform in
+ * [min_exponent, max_exponent]. The generator is always seeded the same way,
+ * so that every call with the same arguments returns the same values.
+ */
+inline std::vector<double> random_values(std::size_t count, int min_exponent, int max_exponent)
+{
+    std::mt19937_64 generator(2021);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(min_exponent, max_exponent);
+    std::vector<double> result(count);
+    for (auto& x : result)
+        x = std::ldexp(mantissa(generator), exponent(generator));
+    return result;
+}
+
+#endif // __RANDOM_VALUES_H__
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
@@ -0,0 +1,137 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "random_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of order-independent summation
+ */
+//============================================================================================
+
+/**
+ * @test The reproducible sum does not depend on the order of summands,
+ * nor on the way they are split between accumulators
+ */
+TEST(compensated_test, reproducible_order_independence)
+{
+    std::vector<double> v = random_values(10000, -60, 60);
+    compensated::reproducible<double> forward;
+    for (double x : v)
+        forward += x;
+
+    std::reverse(v.begin(), v.end());
+    compensated::reproducible<double> backward;
+    backward.accumulate(v.begin(), v.end());
+
+    std::shuffle(v.begin(), v.end(), std::mt19937_64(42));
+    compensated::reproducible<double> shuffled;
+    shuffled.accumulate(v.begin(), v.end());
+
+    compensated::reproducible<double> first_half, second_half;
+    first_half.accumulate(v.begin() + 1234, v.end());
+    second_half.accumulate(v.begin(), v.begin() + 1234);
+    second_half += first_half;
+
+    EXPECT_EQ(double(forward), double(backward));
+    EXPECT_EQ(double(forward), double(shuffled));
+    EXPECT_EQ(double(forward), double(second_half));
+
+    // The sum is accurate as well
+    compensated::value<double, compensated::algorithm::klein> reference{0.0};
+    reference.accumulate(v.begin(), v.end());
+    EXPECT_DOUBLE_EQ(double(forward), double(reference));
+}
+
+/**
+ * @test Cancellation of huge and tiny values, with floats and doubles
+ */
+TEST(compensated_test, reproducible_cancellation)
+{
+    compensated::reproducible<double> rd{huge_dbl};
+    rd += tiny_dbl;
+    rd -= huge_dbl;
+    EXPECT_EQ(double(rd), tiny_dbl);
+
+    std::vector<float> fl = {huge_fl, tiny_fl, -huge_fl, tiny_fl};
+    compensated::reproducible<float> rf;
+    rf.accumulate(fl.begin(), fl.end());
+    EXPECT_EQ(float(rf), 2 * tiny_fl);
+
+    // Non-finite values propagate, also from the vectorized path
+    rd += std::numeric_limits<double>::infinity();
+    EXPECT_TRUE(std::isinf(double(rd)));
+    std::vector<double> with_nan(100, 1.0);
+    with_nan[50] = std::numeric_limits<double>::quiet_NaN();
+    compensated::reproducible<double> rn;
+    rn.accumulate(with_nan.begin(), with_nan.end());
+    EXPECT_TRUE(std::isnan(double(rn)));
+}
+
+/**
+ * @test Summands which fall exactly halfway between two points of the grid
+ * of a bin are rounded the same way in any order, by both the scalar and
+ * the vectorized deposits
+ */
+TEST(compensated_test, reproducible_ties)
+{
+    const double big = 0x1p38, g = 0x1p-80; // g is the grid of the lowest bin
+    std::vector<double> v = {big, 1.5 * g, g, 0.5 * g, -big};
+    std::sort(v.begin(), v.end());
+    compensated::reproducible<double> first;
+    first.accumulate(v.begin(), v.end());
+    do
+    {
+        compensated::reproducible<double> permuted;
+        for (double x : v)
+            permuted += x;
+        EXPECT_EQ(double(permuted), double(first));
+    }
+    while (std::next_permutation(v.begin(), v.end()));
+
+    // Many ties, summed in blocks by the vectorized kernel
+    std::vector<double> ties = {big, -big};
+    for (int i = 0; i < 62; i++)
+        ties.push_back((i % 2 ? -0.5 : 0.5 + (i % 5)) * g);
+    compensated::reproducible<double> scalar;
+    for (double x : ties)
+        scalar += x;
+    std::mt19937_64 generator(7);
+    for (int trial = 0; trial < 20; trial++)
+    {
+        std::shuffle(ties.begin(), ties.end(), generator);
+        compensated::reproducible<double> vectorized;
+        vectorized.accumulate(ties.begin(), ties.end());
+        EXPECT_EQ(double(vectorized), double(scalar));
+    }
+}
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @test The parallel accumulate() gives the same bits as the sequential one
+ */
+TEST(compensated_test, reproducible_parallel)
+{
+    std::vector<double> v = random_values(300000, -60, 60);
+    compensated::reproducible<double> sequential, parallel;
+    for (double x : v)
+        sequential += x;
+    parallel.accumulate(std::execution::par_unseq, v.begin(), v.end());
+    EXPECT_EQ(double(sequential), double(parallel));
+}
+#endif
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
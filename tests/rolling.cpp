@@ -0,0 +1,106 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <cmath>
+#include <list>
+#include <span>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "random_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of sliding-window sums
+ */
+//============================================================================================
+
+/**
+ * @brief The exact sum of the last `width` values pushed, rounded
+ */
+static double window_sum(const std::vector<double>& v, std::size_t end, std::size_t width)
+{
+    compensated::superaccumulator exact;
+    exact.accumulate(v.begin() + (end > width ? end - width : 0), v.begin() + end);
+    return exact;
+}
+
+/**
+ * @test Pushing huge and tiny values through a window of fixed width
+ */
+TEST(compensated_test, rolling_value_basic)
+{
+    compensated::rolling_value<double, 3> window;
+    EXPECT_EQ(window.width(), 3u);
+    EXPECT_EQ(window.size(), 0u);
+    EXPECT_EQ(double(window), 0.0);
+
+    window += huge_dbl;
+    window += tiny_dbl;
+    EXPECT_EQ(window.size(), 2u);
+    EXPECT_EQ(double(window.sum() - huge_dbl), tiny_dbl);
+    window += tiny_dbl;
+    EXPECT_EQ(double(window.sum() - huge_dbl), 2 * tiny_dbl);
+    window += -huge_dbl; // huge leaves, -huge enters
+    EXPECT_EQ(window.size(), 3u);
+    EXPECT_EQ(double(window.sum() + huge_dbl), 2 * tiny_dbl);
+    window += 0.0;
+    window += 0.0;
+    EXPECT_EQ(double(window), -huge_dbl);
+    window += 0.0;
+    EXPECT_EQ(double(window), 0.0);
+
+    window.clear();
+    EXPECT_EQ(window.size(), 0u);
+    EXPECT_EQ(double(window), 0.0);
+}
+
+/**
+ * @test A window of run-time width asserts that the width is positive
+ */
+TEST(compensated_test, rolling_value_zero_width)
+{
+    EXPECT_DEBUG_DEATH(compensated::rolling_value<double>{0}, "");
+    compensated::rolling_value<double> window{1};
+    window += 2.0;
+    window += 3.0;
+    EXPECT_EQ(double(window), 3.0);
+}
+
+/**
+ * @test Long streams of wildly varying values do not make the sum drift,
+ * whether they are pushed one by one or in blocks
+ */
+TEST(compensated_test, rolling_value_no_drift)
+{
+    const std::vector<double> v = random_values(100000, -40, 40);
+
+    compensated::rolling_value<double, 100> single;
+    compensated::rolling_value<double> blocks(100);
+    std::size_t pushed = 0;
+    for (std::size_t block = 1; pushed + block <= v.size(); block = (3 * block + 1) % 257)
+    {
+        for (std::size_t i = pushed; i < pushed + block; i++)
+            single.push(v[i]);
+        blocks.push(v.begin() + pushed, v.begin() + pushed + block);
+        pushed += block;
+        const double exact = window_sum(v, pushed, 100);
+        ASSERT_NEAR(double(single), exact, 1e-15 * std::abs(exact));
+        ASSERT_NEAR(double(blocks), exact, 1e-15 * std::abs(exact));
+    }
+
+    // Blocks without random access are pushed one by one
+    std::list<double> tail(v.end() - 150, v.end());
+    blocks.push(tail.begin(), tail.end());
+    EXPECT_NEAR(double(blocks), window_sum(v, v.size(), 100),
+                1e-15 * std::abs(window_sum(v, v.size(), 100)));
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
@@ -0,0 +1,94 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of compensated prefix sums
+ */
+//============================================================================================
+
+/**
+ * @brief Produces `count` triples (huge, tiny, -huge): the exact prefix sum
+ * after the k-th triple is k * tiny
+ */
+static std::vector<double> lossy_triples(unsigned count)
+{
+    std::vector<double> result;
+    for (unsigned k = 0; k < count; k++)
+        result.insert(result.end(), {huge_dbl, tiny_dbl, -huge_dbl});
+    return result;
+}
+
+/**
+ * @test Sequential scans, into rounded and into compensated outputs
+ */
+TEST(compensated_test, scan_sequential)
+{
+    const std::vector<double> v = lossy_triples(2);
+    std::vector<double> rounded;
+    compensated::inclusive_scan(v.begin(), v.end(), std::back_inserter(rounded));
+    EXPECT_EQ(rounded, (std::vector<double>{huge_dbl, huge_dbl, tiny_dbl,
+                                            huge_dbl + tiny_dbl, huge_dbl, 2 * tiny_dbl}));
+
+    // The compensated outputs keep the tiny parts of the huge sums
+    std::vector<compensated::value<double>> full(v.size());
+    auto end = compensated::inclusive_scan(v.begin(), v.end(), full.begin());
+    EXPECT_EQ(end, full.end());
+    EXPECT_EQ(double(full[1] - huge_dbl), tiny_dbl);
+    EXPECT_EQ(double(full[4] - huge_dbl), 2 * tiny_dbl);
+
+    std::list<double> exclusive;
+    compensated::exclusive_scan(v.begin(), v.end(), std::back_inserter(exclusive), 1.0);
+    EXPECT_EQ(exclusive, (std::list<double>{1.0, 1.0 + huge_dbl, 1.0 + huge_dbl,
+                                            1.0 + tiny_dbl, 1.0 + huge_dbl, 1.0 + huge_dbl}));
+
+    // In place
+    std::vector<double> in_place = v;
+    compensated::inclusive_scan(in_place.begin(), in_place.end(), in_place.begin());
+    EXPECT_EQ(in_place, rounded);
+}
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @test Parallel scans over several chunks
+ */
+TEST(compensated_test, scan_parallel)
+{
+    const unsigned count = 70000;
+    const std::vector<double> v = lossy_triples(count);
+    std::vector<double> inclusive(v.size()), exclusive(v.size());
+    compensated::inclusive_scan(std::execution::par_unseq, v.begin(), v.end(),
+                                inclusive.begin());
+    std::vector<double> in_place = v;
+    compensated::exclusive_scan(std::execution::par, in_place.begin(), in_place.end(),
+                                in_place.begin(), 0.0);
+    for (unsigned k = 0; k < count; k++)
+    {
+        ASSERT_EQ(inclusive[3*k + 1], huge_dbl + (k + 1) * tiny_dbl);
+        ASSERT_EQ(inclusive[3*k + 2], (k + 1) * tiny_dbl);
+        ASSERT_EQ(in_place[3*k], k * tiny_dbl);
+    }
+
+    // Without random access, the scan is sequential
+    std::list<double> list(v.begin(), v.end());
+    std::vector<double> from_list;
+    compensated::inclusive_scan(std::execution::par, list.begin(), list.end(),
+                                std::back_inserter(from_list));
+    EXPECT_EQ(from_list, inclusive);
+}
+#endif
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
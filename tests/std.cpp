@@ -7,6 +7,15 @@
  *
  */
 
+#include <bit>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <ranges>
+#include <span>
 #include <vector>
 
 #include "tests.h"
@@ -35,4 +44,443 @@ TEST(compensated_test, accumulate)
     EXPECT_DOUBLE_EQ(result, 10.0);
 }
 
+/**
+ * @test Test the vectorized accumulate() on contiguous ranges of doubles
+ * and floats, for lengths which exercise both the vector loop and the tail
+ */
+TEST(compensated_test, accumulate_contiguous)
+{
+    for (unsigned length = 0; length < 200; length++)
+    {
+        std::vector<double> dbl;
+        std::vector<float> fl;
+        for (unsigned i = 0; i < length; i++)
+        {   // The pattern huge, tiny, -huge sums to `tiny` every 3 elements
+            dbl.push_back(i % 3 == 0 ? huge_dbl : (i % 3 == 1 ? tiny_dbl : -huge_dbl));
+            fl.push_back(i % 3 == 0 ? huge_fl : (i % 3 == 1 ? tiny_fl : -huge_fl));
+        }
+        unsigned huge_count = (length + 2) / 3;
+        unsigned tiny_count = (length + 1) / 3;
+        unsigned neg_count = length / 3;
+
+        compensated::value<double> kd{0.0};
+        kd.accumulate(dbl.begin(), dbl.end());
+        double expected_dbl = (huge_count - neg_count) * huge_dbl + tiny_count * tiny_dbl;
+        EXPECT_DOUBLE_EQ(double(kd), expected_dbl);
+
+        compensated::value<float> kf{0.0f};
+        kf.accumulate(fl.data(), fl.data() + fl.size());
+        float expected_fl = (huge_count - neg_count) * huge_fl + tiny_count * tiny_fl;
+        EXPECT_FLOAT_EQ(float(kf), expected_fl);
+
+        // The same data in a non-contiguous container
+        std::list<double> lst(dbl.begin(), dbl.end());
+        compensated::value<double> kl{0.0};
+        kl.accumulate(lst.begin(), lst.end());
+        EXPECT_DOUBLE_EQ(double(kl), expected_dbl);
+    }
+}
+
+/**
+ * @test Test the vectorized accumulate() on contiguous ranges of complex
+ * numbers, whose real and imaginary parts cancel independently
+ */
+TEST(compensated_test, accumulate_contiguous_complex)
+{
+    for (unsigned length = 0; length < 200; length++)
+    {
+        std::vector<std::complex<double>> cd;
+        std::vector<std::complex<float>> cf;
+        for (unsigned i = 0; i < length; i++)
+        {   // The real parts repeat huge, tiny, -huge; the imaginary parts tiny, -huge, huge
+            const unsigned k = i % 3;
+            cd.emplace_back(k == 0 ? huge_dbl : (k == 1 ? tiny_dbl : -huge_dbl),
+                            k == 0 ? tiny_dbl : (k == 1 ? -huge_dbl : huge_dbl));
+            cf.emplace_back(k == 0 ? huge_fl : (k == 1 ? tiny_fl : -huge_fl),
+                            k == 0 ? tiny_fl : (k == 1 ? -huge_fl : huge_fl));
+        }
+        const unsigned first = (length + 2) / 3, second = (length + 1) / 3, third = length / 3;
+
+        compensated::value<std::complex<double>> kd;
+        kd.accumulate(cd.begin(), cd.end());
+        EXPECT_DOUBLE_EQ(kd.real(), (first - third) * huge_dbl + second * tiny_dbl);
+        EXPECT_DOUBLE_EQ(kd.imag(), first * tiny_dbl + (double(third) - second) * huge_dbl);
+
+        compensated::value<std::complex<float>> kf;
+        kf.accumulate(cf);
+        EXPECT_FLOAT_EQ(kf.real(), (first - third) * huge_fl + second * tiny_fl);
+        EXPECT_FLOAT_EQ(kf.imag(), first * tiny_fl + (float(third) - second) * huge_fl);
+    }
+}
+
+/**
+ * @test Test accumulate() on contiguous ranges of other arithmetic types,
+ * converted to the raw value type by the vectorized kernel
+ */
+TEST(compensated_test, accumulate_converting)
+{
+    for (unsigned length = 0; length < 100; length++)
+    {
+        std::vector<std::int64_t> integers;
+        std::vector<std::int32_t> small_integers;
+        std::vector<float> fl;
+        std::int64_t expected_integers = 0, expected_small_integers = 0;
+        for (unsigned i = 0; i < length; i++)
+        {   // Integers beyond the precision of float, nearly cancelling in pairs
+            integers.push_back(i % 2 ? -(std::int64_t{1} << 40) + i : (std::int64_t{1} << 40));
+            small_integers.push_back(i % 2 ? -(1 << 30) : (1 << 30) + 1);
+            fl.push_back(i % 3 == 0 ? huge_fl : (i % 3 == 1 ? tiny_fl : -huge_fl));
+            expected_integers += integers.back();
+            expected_small_integers += small_integers.back();
+        }
+        const unsigned tiny_count = (length + 1) / 3;
+        const double expected_floats = double((length + 2) / 3 - length / 3) * huge_fl
+                                     + tiny_count * double(tiny_fl);
+
+        compensated::value<double> from_integers;
+        from_integers.accumulate(integers.begin(), integers.end());
+        EXPECT_EQ(double(from_integers), double(expected_integers));
+
+        compensated::value<double> from_small_integers;
+        from_small_integers.accumulate(std::span<const std::int32_t>(small_integers));
+        EXPECT_EQ(double(from_small_integers), double(expected_small_integers));
+
+        compensated::value<double> from_floats;
+        from_floats.accumulate(fl);
+        EXPECT_DOUBLE_EQ(double(from_floats), expected_floats);
+
+        // Narrowing: the doubles are rounded to floats, one by one
+        std::vector<double> dbl(fl.begin(), fl.end());
+        compensated::value<float> from_doubles;
+        from_doubles.accumulate(dbl.data(), dbl.data() + dbl.size());
+        EXPECT_FLOAT_EQ(float(from_doubles), float(expected_floats));
+    }
+}
+
+/**
+ * @test Test accumulate() on non-contiguous containers, whose elements are
+ * spread over several independent accumulators
+ */
+TEST(compensated_test, accumulate_non_contiguous)
+{
+    for (unsigned length = 0; length < 20; length++)
+    {
+        std::deque<float> fl;
+        std::list<std::complex<double>> cpx;
+        for (unsigned i = 0; i < length; i++)
+        {
+            fl.push_back(i % 2 == 0 ? huge_fl : tiny_fl);
+            cpx.push_back(i % 2 == 0 ? std::complex<double>{huge_dbl, tiny_dbl}
+                                     : std::complex<double>{tiny_dbl, -huge_dbl});
+        }
+        unsigned even = (length + 1) / 2;
+        unsigned odd = length / 2;
+
+        compensated::value<float> kf{-(even * huge_fl)};
+        kf.accumulate(fl.begin(), fl.end());
+        EXPECT_FLOAT_EQ(float(kf), odd * tiny_fl);
+
+        compensated::value<std::complex<double>> kc{{-(even * huge_dbl), odd * huge_dbl}};
+        kc.accumulate(cpx.begin(), cpx.end());
+        EXPECT_DOUBLE_EQ(kc.real(), odd * tiny_dbl);
+        EXPECT_DOUBLE_EQ(kc.imag(), even * tiny_dbl);
+    }
+}
+
+/**
+ * @test The naive and plain Kahan sums of accumulate() add the elements in
+ * order, so that they match a sequential loop
+ */
+TEST(compensated_test, accumulate_in_order)
+{
+    const std::list<double> values = {1e16, 1.0, 1.0, 1.0, -1e16};
+    double loop = 0;
+    compensated::value<double, compensated::algorithm::kahan> kahan_loop;
+    for (double x : values)
+    {
+        loop += x;
+        kahan_loop += x;
+    }
+    EXPECT_EQ(loop, 0.0);
+
+    compensated::value<double, compensated::algorithm::naive> naive, naive_range;
+    naive.accumulate(values.begin(), values.end());
+    naive_range.accumulate(values);
+    EXPECT_EQ(double(naive), loop);
+    EXPECT_EQ(double(naive_range), loop);
+
+    compensated::value<double, compensated::algorithm::kahan> kahan;
+    kahan.accumulate(values.begin(), values.end());
+    EXPECT_EQ(double(kahan), double(kahan_loop));
+    EXPECT_EQ(kahan.error(), kahan_loop.error());
+}
+
+/**
+ * @test Test accumulate() on whole ranges: containers, contiguous ranges of
+ * other arithmetic types, views, and ranges delimited by a sentinel
+ */
+TEST(compensated_test, accumulate_range)
+{
+    std::vector<double> dbl;
+    for (unsigned i = 0; i < 100; i++)
+        dbl.push_back(i % 3 == 0 ? huge_dbl : (i % 3 == 1 ? tiny_dbl : -huge_dbl));
+    const double expected = huge_dbl + 33 * tiny_dbl;
+
+    compensated::value<double> from_vector;
+    from_vector.accumulate(dbl);
+    EXPECT_DOUBLE_EQ(double(from_vector), expected);
+
+    const std::list<double> lst(dbl.begin(), dbl.end());
+    compensated::value<double> from_list;
+    from_list.accumulate(lst);
+    EXPECT_DOUBLE_EQ(double(from_list), expected);
+
+    const int integers[] = {1, 2, 3, 4, 5, 6, 7};
+    compensated::value<double> from_integers{0.5};
+    from_integers.accumulate(integers);
+    EXPECT_EQ(double(from_integers), 28.5);
+
+    // Views: all but every third element, negated, i.e., -tiny and +huge
+    compensated::value<double> from_view;
+    from_view.accumulate(std::views::iota(0u, 100u)
+                         | std::views::filter([](unsigned i) {return i % 3 != 0;})
+                         | std::views::transform([&dbl](unsigned i) {return -dbl[i];}));
+    EXPECT_DOUBLE_EQ(double(from_view), 33 * huge_dbl - 33 * tiny_dbl);
+
+    // A range whose end is a sentinel: up to the first negative element
+    compensated::value<double> from_sentinel;
+    from_sentinel.accumulate(dbl | std::views::take_while([](double x) {return x >= 0;}));
+    EXPECT_DOUBLE_EQ(double(from_sentinel), huge_dbl + tiny_dbl);
+}
+
+/**
+ * @test Test accumulate() on ranges of compensated values, whose errors are
+ * kept by the range overload as by the iterator overload
+ */
+TEST(compensated_test, accumulate_range_of_values)
+{
+    const compensated::value<double> element = compensated::value<double>{1.0} + 1e-20;
+    ASSERT_NE(element.error(), 0.0);
+    const std::vector<compensated::value<double>> vec(4, element);
+    const std::deque<compensated::value<double>> deq(vec.begin(), vec.end());
+
+    compensated::value<double> from_range, from_iterators, from_deque;
+    from_range.accumulate(vec);
+    from_iterators.accumulate(vec.begin(), vec.end());
+    from_deque.accumulate(deq);
+    EXPECT_EQ(from_range.error(), 4e-20);
+    for (const auto& sum : {from_iterators, from_deque})
+    {
+        EXPECT_EQ(std::bit_cast<std::uint64_t>(double(sum)),
+                  std::bit_cast<std::uint64_t>(double(from_range)));
+        EXPECT_EQ(std::bit_cast<std::uint64_t>(sum.error()),
+                  std::bit_cast<std::uint64_t>(from_range.error()));
+    }
+}
+
+/**
+ * @test Test accumulate() on lazy random-access views, which are summed by
+ * the vectorized kernel in chunks, for lengths which leave various tails
+ */
+TEST(compensated_test, accumulate_buffered_view)
+{
+    for (unsigned length : {0u, 1u, 31u, 64u, 255u, 256u, 257u, 600u, 1000u})
+    {
+        auto pattern = [](unsigned i) {return i % 3 == 0 ? 1.0 : (i % 3 == 1 ? 0.0 : -1.0);};
+        const double huge_count = (length + 2) / 3 - length / 3;
+        const double tiny_count = (length + 1) / 3;
+
+        compensated::value<double> kd;
+        kd.accumulate(std::views::iota(0u, length) | std::views::transform([&](unsigned i)
+        {
+            return pattern(i) != 0 ? pattern(i) * huge_dbl : tiny_dbl;
+        }));
+        EXPECT_DOUBLE_EQ(double(kd), huge_count * huge_dbl + tiny_count * tiny_dbl);
+
+        compensated::value<float> kf;
+        kf.accumulate(std::views::iota(0u, length) | std::views::transform([&](unsigned i)
+        {
+            return pattern(i) != 0 ? float(pattern(i)) * huge_fl : tiny_fl;
+        }));
+        EXPECT_FLOAT_EQ(float(kf), huge_count * huge_fl + tiny_count * tiny_fl);
+    }
+}
+
+/**
+ * @test Test accumulate_buffered() on views which accumulate() does not
+ * buffer, for lengths which leave various tails; the result must be the
+ * same as that of accumulate()
+ */
+TEST(compensated_test, accumulate_buffered_filter)
+{
+    for (unsigned length : {0u, 1u, 31u, 64u, 255u, 256u, 257u, 600u, 1000u})
+    {
+        std::vector<double> v;
+        for (unsigned i = 0; i < 2 * length; i++)
+            v.push_back(i % 2 != 0 ? -1.0 : (i % 3 == 0 ? huge_dbl : (i % 3 == 1 ? tiny_dbl : -huge_dbl)));
+        auto filtered = v | std::views::filter([](double x) {return x != -1.0;});
+
+        compensated::value<double, compensated::algorithm::klein> expected;
+        for (double x : filtered)
+            expected += x;
+        compensated::value<double> unbuffered, buffered;
+        unbuffered.accumulate(filtered);
+        buffered.accumulate_buffered(filtered);
+        EXPECT_DOUBLE_EQ(double(unbuffered), double(expected));
+        EXPECT_DOUBLE_EQ(double(buffered), double(expected));
+
+        std::list<float> l(length, 0.5f);
+        compensated::value<float, compensated::algorithm::two_sum> list_sum;
+        list_sum.accumulate_buffered(l | std::views::transform([](float x) {return 2 * x;}));
+        EXPECT_EQ(float(list_sum), float(length));
+    }
+}
+
+#if defined(COMPENSATED_EXECUTION_POLICIES)
+/**
+ * @test Test accumulate() under the standard execution policies; the
+ * result must not depend on the policy
+ */
+TEST(compensated_test, accumulate_parallel)
+{
+    const unsigned length = 1000003;
+    std::vector<double> v;
+    for (unsigned i = 0; i < length; i++)
+        v.push_back(i % 3 == 0 ? huge_dbl : (i % 3 == 1 ? tiny_dbl : -huge_dbl));
+    const double expected = huge_dbl + (length / 3) * tiny_dbl;
+
+    compensated::value<double> seq{0.0}, par{0.0}, par_unseq{0.0};
+    seq.accumulate(std::execution::seq, v.begin(), v.end());
+    par.accumulate(std::execution::par, v.begin(), v.end());
+    par_unseq.accumulate(std::execution::par_unseq, v.cbegin(), v.cend());
+    EXPECT_DOUBLE_EQ(double(seq), expected);
+    EXPECT_EQ(double(seq), double(par));
+    EXPECT_EQ(double(seq), double(par_unseq));
+
+    // Ranges without random access are summed sequentially
+    std::list<double> lst(v.begin(), v.begin() + 999);
+    compensated::value<double> from_list{0.0};
+    from_list.accumulate(std::execution::par, lst.begin(), lst.end());
+    EXPECT_DOUBLE_EQ(double(from_list), 333 * tiny_dbl);
+}
+#endif
+
+/**
+ * @test The vectorized kernels run only on an instruction set which the
+ * processor supports, at most the one requested in COMPENSATED_ISA
+ */
+TEST(compensated_test, kernel_instruction_set)
+{
+    using compensated::instruction_set;
+    const instruction_set selected = compensated::kernel_instruction_set();
+    EXPECT_EQ(selected, compensated::kernel_instruction_set());
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+    if (selected >= instruction_set::avx2)
+    {
+        EXPECT_TRUE(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+    }
+    if (selected == instruction_set::avx512)
+    {
+        EXPECT_TRUE(__builtin_cpu_supports("avx512f"));
+    }
+
+    const char* requested = std::getenv("COMPENSATED_ISA");
+    if (requested != nullptr && std::strcmp(requested, "baseline") == 0)
+    {
+        EXPECT_EQ(selected, instruction_set::baseline);
+    }
+    if (requested != nullptr && std::strcmp(requested, "avx2") == 0)
+    {
+        EXPECT_TRUE(selected <= instruction_set::avx2);
+    }
+#else
+    EXPECT_EQ(selected, instruction_set::baseline);
+#endif
+
+    std::vector<double> x, y;
+    for (unsigned i = 0; i < 1000; i++)
+    {
+        x.push_back(i % 2 ? huge_dbl : -huge_dbl);
+        y.push_back(double(i));
+    }
+    compensated::value<double> sum, products;
+    sum.accumulate(y);
+    products.accumulate_products(y.begin(), y.end(), x.begin());
+    EXPECT_EQ(double(sum), 499500.0);
+    EXPECT_DOUBLE_EQ(double(products), 500 * huge_dbl);
+}
+
+/**
+ * @test Each variant of the vectorized kernels which the processor supports,
+ * run in turn within the process, sums exactly where the compensation
+ * recovers all the rounding errors
+ */
+TEST(compensated_test, kernel_variants)
+{
+    namespace detail = compensated::detail;
+    using compensated::instruction_set;
+    std::vector<instruction_set> variants = {instruction_set::baseline};
+#if defined(COMPENSATED_RUNTIME_DISPATCH)
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        variants.push_back(instruction_set::avx2);
+        if (__builtin_cpu_supports("avx512f"))
+            variants.push_back(instruction_set::avx512);
+    }
+#endif
+
+    // Long enough for the widest variants, with a tail:
+    std::vector<double> doubles, near_one, near_one_too;
+    std::vector<float> floats;
+    std::vector<std::complex<double>> complexes;
+    const double double_pattern[] = {huge_dbl, 1.0, -huge_dbl, tiny_dbl};
+    const float float_pattern[] = {huge_fl, 1.0f, -huge_fl, tiny_fl};
+    for (unsigned i = 0; i < 1003; i++)
+    {
+        doubles.push_back(double_pattern[i % 4]);
+        floats.push_back(float_pattern[i % 4]);
+        complexes.emplace_back(double_pattern[i % 4], -double_pattern[(i + 2) % 4]);
+        near_one.push_back(1.0 + 0x1p-30);
+        near_one_too.push_back(1.0 - 0x1p-30);
+    }
+
+    for (instruction_set isa : variants)
+    {
+        SCOPED_TRACE(static_cast<int>(isa));
+        double sum, compensation;
+        detail::run_variant(isa, [&]<std::size_t bytes, bool>()
+        {
+            detail::sum_kernel<double, detail::lanes_in<double, bytes>>(
+                doubles.data(), doubles.size(), sum, compensation);
+        });
+        EXPECT_EQ(sum + compensation, 251 + 250 * tiny_dbl);
+
+        float float_sum, float_compensation;
+        detail::run_variant(isa, [&]<std::size_t bytes, bool>()
+        {
+            detail::sum_kernel<float, detail::lanes_in<float, bytes>>(
+                floats.data(), floats.size(), float_sum, float_compensation);
+        });
+        EXPECT_EQ(float_sum + float_compensation, 251 + 250 * tiny_fl);
+
+        // Each product 1 - 2^-60 is rounded to 1:
+        detail::run_variant(isa, [&]<std::size_t bytes, bool fused>()
+        {
+            detail::dot_kernel<double, detail::lanes_in<double, bytes>, 4, fused>(
+                near_one.data(), near_one_too.data(), near_one.size(), sum, compensation);
+        });
+        EXPECT_EQ(sum, 1003.0);
+        EXPECT_EQ(compensation, -1003 * 0x1p-60);
+
+        std::complex<double> complex_sum, complex_compensation;
+        detail::run_variant(isa, [&]<std::size_t bytes, bool>()
+        {
+            detail::complex_sum_kernel<double, std::max<std::size_t>(2, detail::lanes_in<double, bytes>)>(
+                complexes.data(), complexes.size(), complex_sum, complex_compensation);
+        });
+        EXPECT_EQ(complex_sum + complex_compensation,
+                  std::complex<double>(251 + 250 * tiny_dbl, -250 - 251 * tiny_dbl));
+    }
+}
+
 // vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
\ No newline at end of file
@@ -0,0 +1,203 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "random_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of arrays of compensated sums
+ */
+//============================================================================================
+
+/**
+ * @test The element-wise updates of value_array give the same results as
+ * the updates of individual value objects, bit for bit
+ */
+TEST(compensated_test, value_array_matches_value)
+{
+    const std::size_t size = 37; // not a multiple of the vector width
+    const std::vector<double> values = random_values(100 * size, -60, 60);
+
+    compensated::value_array<double> array(size);
+    std::vector<compensated::value<double>> reference(size);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.sums().data()) % 64, 0u);
+    for (std::size_t step = 0; step < 100; step++)
+    {
+        const std::span<const double> v(values.data() + step * size, size);
+        if (step % 3 == 2)
+        {
+            array -= v;
+            for (std::size_t i = 0; i < size; i++)
+                reference[i] -= v[i];
+        }
+        else
+        {
+            array += v;
+            for (std::size_t i = 0; i < size; i++)
+                reference[i] += v[i];
+        }
+    }
+
+    std::vector<double> rounded = array.round();
+    for (std::size_t i = 0; i < size; i++)
+    {
+        EXPECT_EQ(rounded[i], double(reference[i]));
+        EXPECT_EQ(double(array[i]), double(reference[i]));
+        EXPECT_EQ(array[i].error(), reference[i].error());
+    }
+
+    // Merging arrays
+    compensated::value_array<double> doubled = array;
+    doubled += array;
+    for (std::size_t i = 0; i < size; i++)
+        EXPECT_EQ(double(doubled[i]), double(reference[i] + reference[i]));
+}
+
+/**
+ * @test Scatter updates, gather and single-element access
+ */
+TEST(compensated_test, value_array_scatter_gather)
+{
+    compensated::value_array<float> array(4);
+    const std::vector<std::size_t> indices = {2, 0, 2, 2, 3};
+    const std::vector<float> values = {huge_fl, 1.0f, tiny_fl, -huge_fl, 5.0f};
+    array.add_at(indices.begin(), indices.end(), values.begin());
+    array.subtract_at(indices.begin() + 4, indices.end(), values.begin() + 4);
+    array.add(1, 2.0f);
+
+    std::vector<float> gathered;
+    const std::vector<std::size_t> which = {2, 1, 0, 3};
+    array.gather(which.begin(), which.end(), std::back_inserter(gathered));
+    EXPECT_EQ(gathered, (std::vector<float>{tiny_fl, 2.0f, 1.0f, 0.0f}));
+
+    compensated::value<float> v{huge_fl};
+    v += tiny_fl;
+    array.set(3, v);
+    EXPECT_EQ(float(array[3] - huge_fl), tiny_fl);
+
+    array.resize(6);
+    EXPECT_EQ(array.size(), 6u);
+    EXPECT_EQ(float(array[5]), 0.0f);
+    array.clear();
+    EXPECT_EQ(array.round(), std::vector<float>(6, 0.0f));
+}
+
+/**
+ * @test The element-wise updates assert that the sizes match, as the element
+ * access asserts that the index is valid; without assertions, the extra
+ * elements are ignored
+ */
+TEST(compensated_test, value_array_size_mismatch)
+{
+    compensated::value_array<double> array(4);
+    const std::vector<double> longer(5, 1.0), shorter(3, 1.0);
+    EXPECT_DEBUG_DEATH(array += longer, "");
+    EXPECT_DEBUG_DEATH(array -= shorter, "");
+    EXPECT_DEBUG_DEATH(array += compensated::value_array<double>(2), "");
+#if defined(NDEBUG)
+    EXPECT_EQ(array.round(), (std::vector<double>{0.0, 0.0, 0.0, 1.0}));
+#else
+    EXPECT_DEATH(array.add(4, 1.0), "");
+    EXPECT_EQ(array.round(), std::vector<double>(4, 0.0));
+#endif
+}
+
+/**
+ * @test Reductions of a table along its axes, in various layouts, against
+ * sums of the individual rows and columns
+ */
+TEST(compensated_test, reduce_table)
+{
+    const std::size_t rows = 7, columns = 37;
+    std::vector<double> table(rows * columns);
+    for (std::size_t r = 0; r < rows; r++)
+        for (std::size_t c = 0; c < columns; c++)
+            table[r * columns + c] = r % 3 == 0 ? huge_dbl : (r % 3 == 1 ? (c + 1) * tiny_dbl
+                                                                          : -huge_dbl);
+
+    // Column sums: huge + 2 * (c + 1) * tiny; row sums with the vectorized kernel
+    const auto column_sums = compensated::reduce(table.data(), {rows, columns}, 0);
+    const auto row_sums = compensated::reduce(table.data(), {rows, columns}, 1);
+    ASSERT_EQ(column_sums.size(), columns);
+    ASSERT_EQ(row_sums.size(), rows);
+    for (std::size_t c = 0; c < columns; c++)
+        EXPECT_DOUBLE_EQ(double(column_sums[c]), huge_dbl + 2.0 * (c + 1) * tiny_dbl);
+    for (std::size_t r = 0; r < rows; r++)
+    {
+        compensated::value<double> expected;
+        expected.accumulate(table.begin() + r * columns, table.begin() + (r + 1) * columns);
+        EXPECT_DOUBLE_EQ(double(row_sums[r]), double(expected));
+    }
+
+    // The transposed table, as a column-major view, and the table upside down
+    const std::ptrdiff_t width = columns;
+    const auto transposed = compensated::reduce(table.data(), {columns, rows}, {1, width}, 1);
+    const auto upside_down = compensated::reduce(table.data() + (rows - 1) * columns,
+                                                 {rows, columns}, {-width, 1}, 0);
+    for (std::size_t c = 0; c < columns; c++)
+    {
+        EXPECT_EQ(double(transposed[c]), double(column_sums[c]));
+        EXPECT_DOUBLE_EQ(double(upside_down[c]), double(column_sums[c]));
+    }
+}
+
+/**
+ * @test The reductions assert that the axis is less than the rank
+ */
+TEST(compensated_test, reduce_axis_out_of_range)
+{
+    const std::vector<double> table(6, 1.0);
+    EXPECT_DEBUG_DEATH(compensated::reduce(table.data(), {2, 3}, 2), "");
+    EXPECT_DEBUG_DEATH(compensated::reduce(table.data(), {2, 3}, {3, 1}, 5), "");
+}
+
+/**
+ * @test Reductions of a three-dimensional array along each of its axes
+ */
+TEST(compensated_test, reduce_three_dimensions)
+{
+    const std::size_t extents[3] = {3, 4, 33};
+    std::vector<float> data(extents[0] * extents[1] * extents[2]);
+    for (std::size_t i = 0; i < data.size(); i++)
+        data[i] = i % 2 == 0 ? huge_fl : tiny_fl;
+    auto element = [&](std::size_t i, std::size_t j, std::size_t k)
+    {
+        return data[(i * extents[1] + j) * extents[2] + k];
+    };
+
+    for (std::size_t axis = 0; axis < 3; axis++)
+    {
+        const auto result = compensated::reduce(data.data(), {extents[0], extents[1], extents[2]},
+                                                axis);
+        // The remaining extents, in order
+        std::size_t outer = 0, inner = 0;
+        for (std::size_t d = 0; d < 3; d++)
+            if (d != axis)
+                (outer == 0 ? outer : inner) = extents[d];
+        ASSERT_EQ(result.size(), outer * inner);
+
+        for (std::size_t a = 0; a < outer; a++)
+            for (std::size_t b = 0; b < inner; b++)
+            {
+                compensated::value<float> expected;
+                for (std::size_t t = 0; t < extents[axis]; t++)
+                    expected += axis == 0 ? element(t, a, b)
+                              : (axis == 1 ? element(a, t, b) : element(a, b, t));
+                EXPECT_FLOAT_EQ(float(result[a * inner + b]), float(expected));
+            }
+    }
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :
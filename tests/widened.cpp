@@ -0,0 +1,85 @@
+/** encoding: UTF-8
+ *
+ * © Copyright 2021 Rafał M. Siejakowski <rs@rs-math.net>
+ *
+ * This software is licensed under the terms of the 3-Clause BSD License.
+ * Please refer to the accompanying LICENSE file for the license terms.
+ *
+ */
+
+#include <list>
+#include <vector>
+
+#include "tests.h"
+#include "lossy_values.h"
+#include "../compensated.h"
+
+/**
+ * @file Tests of sums of floats accumulated in doubles
+ */
+//============================================================================================
+
+/**
+ * @test The vectorized widening kernel gives the sum in double, for lengths
+ * which exercise both the vector loop and the tail
+ */
+TEST(compensated_test, widened_contiguous)
+{
+    for (unsigned length = 0; length < 150; length++)
+    {
+        std::vector<float> fl;
+        double expected = 0;
+        for (unsigned i = 0; i < length; i++)
+        {
+            fl.push_back(0.1f * float(i % 7) + 1.0f);
+            expected += double(fl.back()); // exact: few bits of the double are used
+        }
+
+        compensated::widened_value<float> plain;
+        plain.accumulate(fl);
+        EXPECT_EQ(double(plain.wide()), expected);
+        EXPECT_EQ(float(plain), float(expected));
+
+        compensated::widened_value<float, compensated::algorithm::neumaier> compensated;
+        compensated.accumulate(fl.begin(), fl.end());
+        EXPECT_EQ(double(compensated.wide()), expected);
+
+        // The same data in a non-contiguous container
+        std::list<float> lst(fl.begin(), fl.end());
+        compensated::widened_value<float> from_list;
+        from_list.accumulate(lst.begin(), lst.end());
+        EXPECT_EQ(double(from_list.wide()), expected);
+    }
+}
+
+/**
+ * @test Cancellation beyond the precision of double needs a compensated
+ * algorithm in the wide type
+ */
+TEST(compensated_test, widened_cancellation)
+{
+    const float huge = 0x1p40f, tiny = 0x1p-40f;
+    std::vector<float> fl;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        fl.push_back(huge);
+        fl.push_back(tiny);
+        fl.push_back(-huge);
+    }
+
+    compensated::widened_value<float> plain;
+    plain.accumulate(fl);
+    EXPECT_EQ(float(plain), 0.0f);
+
+    compensated::widened_value<float, compensated::algorithm::neumaier> neumaier{huge};
+    neumaier.accumulate(fl);
+    neumaier -= huge;
+    EXPECT_EQ(float(neumaier), 100 * tiny);
+
+    compensated::widened_value<float, compensated::algorithm::neumaier> other;
+    other += tiny_fl;
+    neumaier += other;
+    EXPECT_FLOAT_EQ(float(neumaier), 100 * tiny + tiny_fl);
+}
+
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=4:softtabstop=4:fenc=utf-8 :